@@ -0,0 +1,66 @@
+#ifndef ANALYSIS_HPP
+#define ANALYSIS_HPP
+
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/Constants.hpp"
+#include "Utils/TripleBuffer.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Per-cell values of the analysed position, from the side to move's point of view. A cell with
+// depth 0 has not been searched (yet).
+struct AnalysisResult
+{
+	std::uint64_t generation_;
+	std::array<int, constants::max_board_cells> scores_;
+	std::array<std::uint8_t, constants::max_board_cells> depths_;
+};
+
+// Scores every empty cell of a position on a background thread, sweeping all cells one depth
+// deeper at a time and publishing after each cell so the overlay fills in progressively. The
+// transposition table is kept between positions: after a move, the new position's children
+// were grandchildren of the old one, so most of the tree is already in the table.
+class Analysis
+{
+private:
+	Search search_;
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	Position position_;
+	std::uint64_t generation_;
+	bool has_position_;
+	bool stopping_;
+
+	TripleBuffer<AnalysisResult> results_;
+
+	void Loop();
+
+	// Returns false once the analysed position was replaced or cleared.
+	bool Current(std::uint64_t generation);
+
+public:
+	Analysis();
+
+	~Analysis();
+
+	Analysis(const Analysis&) = delete;
+
+	Analysis& operator=(const Analysis&) = delete;
+
+	// Interrupts whatever is being analysed; results for the new position carry the returned
+	// generation.
+	std::uint64_t SetPosition(const Position& position);
+
+	void Clear();
+
+	// Latest published values. Single reader only.
+	const AnalysisResult& Latest();
+};
+
+#endif
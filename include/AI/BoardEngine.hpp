@@ -0,0 +1,200 @@
+#ifndef BOARD_ENGINE_HPP
+#define BOARD_ENGINE_HPP
+
+#include "AI/Position.hpp"
+#include "Utils/Constants.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Win detection for one board size, picked at runtime by SelectBoardEngine.
+struct BoardEngineFunctions
+{
+	bool (*is_winning_move_)(const CellSymbol* cells, std::size_t index);
+	CellSymbol (*winner_)(const CellSymbol* cells);
+};
+
+namespace board_engine
+{
+	inline constexpr int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+	template <int K>
+	using Line = std::array<std::uint8_t, K>;
+
+	// Cells stepping away from a cell in one direction, up to K - 1 of them or the board edge.
+	template <int K>
+	struct Ray
+	{
+		std::array<std::uint8_t, K - 1> cells_;
+		std::uint8_t length_;
+	};
+
+	template <int N, int K>
+	constexpr int LineCount()
+	{
+		return 2 * N * (N - K + 1) + 2 * (N - K + 1) * (N - K + 1);
+	}
+
+	// Every window of K cells along a row, column or diagonal, in board order.
+	template <int N, int K>
+	constexpr std::array<Line<K>, LineCount<N, K>()> GenerateLines()
+	{
+		std::array<Line<K>, LineCount<N, K>()> lines = {};
+		std::size_t n_lines = 0;
+
+		for (const auto& direction : directions)
+		{
+			for (int row = 0; row < N; ++row)
+			{
+				for (int col = 0; col < N; ++col)
+				{
+					const int end_row = row + direction[0] * (K - 1);
+					const int end_col = col + direction[1] * (K - 1);
+
+					if (end_row < 0 || end_row >= N || end_col < 0 || end_col >= N)
+					{
+						continue;
+					}
+
+					for (int i = 0; i < K; ++i)
+					{
+						lines[n_lines][i] = static_cast<std::uint8_t>((row + direction[0] * i) * N + col + direction[1] * i);
+					}
+
+					++n_lines;
+				}
+			}
+		}
+
+		return lines;
+	}
+
+	// rays[cell][d] walks along directions[d % 4], forwards for d < 4 and backwards otherwise.
+	template <int N, int K>
+	constexpr std::array<std::array<Ray<K>, 8>, N * N> GenerateRays()
+	{
+		std::array<std::array<Ray<K>, 8>, N * N> rays = {};
+
+		for (int cell = 0; cell < N * N; ++cell)
+		{
+			for (int d = 0; d < 8; ++d)
+			{
+				const int sign = d < 4 ? 1 : -1;
+				const int row_step = sign * directions[d % 4][0];
+				const int col_step = sign * directions[d % 4][1];
+
+				Ray<K>& ray = rays[cell][d];
+				int row = cell / N + row_step;
+				int col = cell % N + col_step;
+
+				while (ray.length_ < K - 1 && row >= 0 && row < N && col >= 0 && col < N)
+				{
+					ray.cells_[ray.length_++] = static_cast<std::uint8_t>(row * N + col);
+					row += row_step;
+					col += col_step;
+				}
+			}
+		}
+
+		return rays;
+	}
+} // namespace board_engine
+
+// Board engine for an N x N board with K in a row to win. The line and ray tables are built at
+// compile time, so the checks index straight into them with no bounds arithmetic.
+template <int N, int K>
+class BoardEngine
+{
+public:
+	static_assert(K >= 2 && K <= N, "K must be between 2 and N");
+	static_assert(N * N <= static_cast<int>(constants::max_board_cells), "board larger than Position supports");
+
+	static constexpr int n_cells = N * N;
+	static constexpr int n_lines = board_engine::LineCount<N, K>();
+
+	static constexpr std::array<board_engine::Line<K>, n_lines> lines = board_engine::GenerateLines<N, K>();
+	static constexpr std::array<std::array<board_engine::Ray<K>, 8>, n_cells> rays = board_engine::GenerateRays<N, K>();
+
+	// True if the stone on index is part of K in a row.
+	static bool IsWinningMove(const CellSymbol* cells, std::size_t index);
+
+	static CellSymbol Winner(const CellSymbol* cells);
+
+	static constexpr BoardEngineFunctions functions = { &IsWinningMove, &Winner };
+
+private:
+	static int Run(const CellSymbol* cells, const board_engine::Ray<K>& ray, CellSymbol symbol)
+	{
+		int length = 0;
+
+		while (length < ray.length_ && cells[ray.cells_[length]] == symbol)
+		{
+			++length;
+		}
+
+		return length;
+	}
+};
+
+template <int N, int K>
+bool BoardEngine<N, K>::IsWinningMove(const CellSymbol* cells, std::size_t index)
+{
+	const CellSymbol symbol = cells[index];
+
+	if (symbol == CellSymbol::EMPTY)
+	{
+		return false;
+	}
+
+	const std::array<board_engine::Ray<K>, 8>& cell_rays = rays[index];
+
+	for (int d = 0; d < 4; ++d)
+	{
+		if (1 + Run(cells, cell_rays[d], symbol) + Run(cells, cell_rays[d + 4], symbol) >= K)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template <int N, int K>
+CellSymbol BoardEngine<N, K>::Winner(const CellSymbol* cells)
+{
+	for (const board_engine::Line<K>& line : lines)
+	{
+		const CellSymbol symbol = cells[line[0]];
+		int length = 1;
+
+		while (symbol != CellSymbol::EMPTY && length < K && cells[line[length]] == symbol)
+		{
+			++length;
+		}
+
+		if (length == K)
+		{
+			return symbol;
+		}
+	}
+
+	return CellSymbol::EMPTY;
+}
+
+// 3x3 looks the whole board up in a 3^9 table of winners, without branching. It answers whether
+// the mover has any line, which is the same thing as long as play stops at the first win.
+template <>
+bool BoardEngine<3, 3>::IsWinningMove(const CellSymbol* cells, std::size_t index);
+
+template <>
+CellSymbol BoardEngine<3, 3>::Winner(const CellSymbol* cells);
+
+extern template class BoardEngine<3, 3>;
+extern template class BoardEngine<4, 4>;
+extern template class BoardEngine<15, 5>;
+
+// Specialised engine for the variant, or nullptr when it has none and the generic scan applies.
+const BoardEngineFunctions* SelectBoardEngine(std::size_t dimension, std::size_t n_symbols_to_win);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include "AI/Position.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Features count the winning windows (every run of n_symbols_to_win cells along a row, column or
+// diagonal) that only one side occupies, bucketed by how many stones that side still needs.
+// Counts are taken from the side to move's perspective, so the same weights serve any variant.
+namespace evaluation
+{
+	inline constexpr std::size_t max_missing = 4;
+
+	enum Feature : std::size_t
+	{
+		OWN_WINDOWS = 0,
+		OPPONENT_WINDOWS = OWN_WINDOWS + max_missing,
+		TEMPO = OPPONENT_WINDOWS + max_missing,
+		N_FEATURES
+	};
+
+	// Kept well below Search::win_threshold so a heuristic score is never mistaken for a mate.
+	inline constexpr int max_score = 5000;
+
+	using FeatureVector = std::array<std::int16_t, N_FEATURES>;
+	using Weights = std::array<float, N_FEATURES>;
+} // namespace evaluation
+
+class Evaluator
+{
+private:
+	evaluation::Weights weights_;
+
+public:
+	Evaluator();
+
+	// Process-wide evaluator used by every Search unless one is set explicitly. Load weights into
+	// it at startup, before any search runs.
+	static Evaluator& Default();
+
+	static evaluation::Weights DefaultWeights();
+
+	static void Features(const Position& position, evaluation::FeatureVector* features);
+
+	int Evaluate(const Position& position) const;
+
+	float Score(const evaluation::FeatureVector& features) const;
+
+	const evaluation::Weights& GetWeights() const;
+
+	void SetWeights(const evaluation::Weights& weights);
+
+	// Binary layout: "EVW1", uint32 feature count, float weights (host byte order).
+	bool LoadFromFile(const char* path);
+
+	bool SaveToFile(const char* path) const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef NETWORK_HPP
+#define NETWORK_HPP
+
+#include "AI/Position.hpp"
+#include "Utils/Constants.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Efficiently updatable network: one input per (cell, own or opponent stone) feeds an int16
+// accumulator kept for both colours, so a move only adds one weight column per perspective.
+// The side to move's and the opponent's accumulators are clipped to [0, 127], concatenated and
+// passed through an int8 hidden layer and an int8 output.
+namespace nnue
+{
+	inline constexpr std::size_t grid_dimension = constants::max_board_dimension;
+	inline constexpr std::size_t n_inputs = 2 * grid_dimension * grid_dimension;
+	inline constexpr std::size_t l1_size = 128;
+	inline constexpr std::size_t l2_size = 32;
+
+	// Hidden weights are scaled by 64, activations by 127; the output is divided by this to
+	// land in evaluation units.
+	inline constexpr int hidden_shift = 6;
+	inline constexpr int output_divisor = 16;
+
+	struct alignas(32) Accumulator
+	{
+		// Indexed by perspective: 0 for X, 1 for O.
+		std::array<std::array<std::int16_t, l1_size>, 2> values_;
+	};
+} // namespace nnue
+
+class Network
+{
+private:
+	alignas(32) std::array<std::int16_t, nnue::l1_size> feature_biases_;
+	alignas(32) std::array<std::array<std::int16_t, nnue::l1_size>, nnue::n_inputs> feature_weights_;
+	alignas(32) std::array<std::int32_t, nnue::l2_size> hidden_biases_;
+	alignas(32) std::array<std::array<std::int8_t, 2 * nnue::l1_size>, nnue::l2_size> hidden_weights_;
+	alignas(32) std::array<std::int8_t, nnue::l2_size> output_weights_;
+	std::int32_t output_bias_;
+	bool loaded_;
+
+	static std::size_t FeatureIndex(std::size_t perspective, CellSymbol symbol, std::size_t index, std::size_t dimension);
+
+public:
+	Network();
+
+	// Process-wide network used by every Search unless one is set explicitly. Stays inactive
+	// until weights are loaded.
+	static Network& Default();
+
+	// True when weights are loaded and the board is large enough for the network to replace
+	// the pattern evaluator.
+	bool Applies(const Position& position) const;
+
+	// Rebuilds both perspectives from scratch.
+	void Refresh(const Position& position, nnue::Accumulator* accumulator) const;
+
+	// Derives the accumulator after the stone at index was placed from the one before it. The
+	// parent is left untouched, so undoing the move is just going back to it.
+	void Update(const nnue::Accumulator& parent, nnue::Accumulator* child, const Position& position, std::size_t index) const;
+
+	int Evaluate(const nnue::Accumulator& accumulator, CellSymbol side_to_move) const;
+
+	// Binary layout (host byte order): "NNU1", uint32 inputs, l1 and l2 sizes, then int16
+	// feature biases[l1], int16 feature weights[inputs][l1], int32 hidden biases[l2], int8
+	// hidden weights[l2][2 * l1], int32 output bias, int8 output weights[l2]. The first half of
+	// the inputs are own stones by grid cell (row * 15 + col), the second half opponent stones.
+	bool LoadFromFile(const char* path);
+
+	bool SaveToFile(const char* path) const;
+};
+
+#endif
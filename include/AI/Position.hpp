@@ -0,0 +1,66 @@
+#ifndef POSITION_HPP
+#define POSITION_HPP
+
+#include "Utils/Constants.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class CellSymbol
+{
+	EMPTY, X, O
+};
+
+struct BoardEngineFunctions;
+
+class Position
+{
+private:
+	std::array<CellSymbol, constants::max_board_cells> cells_;
+	std::size_t dimension_;
+	std::size_t n_symbols_to_win_;
+	std::size_t free_cells_;
+	CellSymbol side_to_move_;
+	std::uint64_t hash_;
+
+	// Compile-time specialised win detection for the hot variants, nullptr for the rest.
+	const BoardEngineFunctions* engine_;
+
+	std::size_t CountInDirection(std::size_t index, int row_step, int col_step, CellSymbol symbol) const;
+
+public:
+	Position();
+
+	Position(std::size_t dimension, std::size_t n_symbols_to_win, CellSymbol side_to_move);
+
+	void Reset(std::size_t dimension, std::size_t n_symbols_to_win, CellSymbol side_to_move);
+
+	void Set(std::size_t index, CellSymbol symbol);
+
+	void MakeMove(std::size_t index);
+
+	void UnmakeMove(std::size_t index);
+
+	bool IsWinningMove(std::size_t index) const;
+
+	bool HasWinner(CellSymbol* winning_symbol = nullptr) const;
+
+	CellSymbol At(std::size_t index) const;
+
+	std::size_t Cells() const;
+
+	std::size_t Dimension() const;
+
+	std::size_t NSymbolsToWin() const;
+
+	std::size_t FreeCells() const;
+
+	CellSymbol SideToMove() const;
+
+	std::uint64_t Hash() const;
+
+	static CellSymbol Opponent(CellSymbol symbol);
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef PROOF_NUMBER_SEARCH_HPP
+#define PROOF_NUMBER_SEARCH_HPP
+
+#include "AI/Position.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Depth-first proof-number search (df-pn) answering "can the attacker force a win?".
+// Draws count as a success for the defender. All state lives in a fixed-size table, so the
+// memory budget is bounded and a checkpoint is simply a dump of that table.
+class ProofNumberSearch
+{
+private:
+	struct Entry
+	{
+		std::uint64_t key_;
+		std::uint32_t pn_;
+		std::uint32_t dn_;
+		std::uint64_t work_;
+	};
+
+	static constexpr std::size_t bucket_size = 4;
+
+	std::vector<Entry> table_;
+	CellSymbol attacker_;
+	Position root_;
+	std::uint64_t nodes_;
+	std::uint64_t next_checkpoint_;
+	std::uint64_t checkpoint_interval_;
+	std::string checkpoint_path_;
+
+	void MultipleIterativeDeepening(Position& position, std::uint32_t pn_threshold, std::uint32_t dn_threshold);
+
+	bool ChildNumbers(Position& position, std::size_t index, std::uint32_t* pn, std::uint32_t* dn);
+
+	void SolvedChildNumbers(Position& position, std::size_t index, std::uint32_t* pn, std::uint32_t* dn);
+
+	bool Lookup(std::uint64_t key, std::uint32_t* pn, std::uint32_t* dn) const;
+
+	void StoreEntry(std::uint64_t key, std::uint32_t pn, std::uint32_t dn, std::uint64_t work);
+
+	void WriteTree(Position& position, bool proof, std::size_t ply, std::ostream& out);
+
+public:
+	static constexpr std::uint32_t infinity = 1u << 30;
+
+	ProofNumberSearch(CellSymbol attacker, std::size_t memory_bytes);
+
+	void SetCheckpoint(const std::string& path, std::uint64_t interval);
+
+	bool LoadCheckpoint(const Position& root);
+
+	bool SaveCheckpoint() const;
+
+	bool Solve(Position root);
+
+	void WriteProofTree(Position root, std::ostream& out);
+
+	std::uint64_t Nodes() const;
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef QUBIC_HPP
+#define QUBIC_HPP
+
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "AI/TranspositionTable.hpp"
+#include "Utils/Constants.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// 4x4x4 tic-tac-toe. Cell index is layer * 16 + row * 4 + col, so each side's stones fit in one
+// 64-bit word and a line is a mask over it.
+namespace qubic
+{
+	inline constexpr int side = 4;
+	inline constexpr int n_cells = side * side * side;
+	inline constexpr int n_lines = 76;
+	inline constexpr int max_cell_lines = 7;
+
+	// Every line through the cube: 48 along the axes, 24 face diagonals and 4 space diagonals.
+	constexpr std::array<std::uint64_t, n_lines> GenerateLines()
+	{
+		std::array<std::uint64_t, n_lines> lines = {};
+		std::size_t n_generated = 0;
+
+		for (int dz = -1; dz <= 1; ++dz)
+		{
+			for (int dy = -1; dy <= 1; ++dy)
+			{
+				for (int dx = -1; dx <= 1; ++dx)
+				{
+					// One of each opposite pair: the first non-zero step has to be positive.
+					const int first_step = dz != 0 ? dz : (dy != 0 ? dy : dx);
+
+					if (first_step <= 0)
+					{
+						continue;
+					}
+
+					for (int cell = 0; cell < n_cells; ++cell)
+					{
+						const int z = cell / 16;
+						const int y = cell / 4 % 4;
+						const int x = cell % 4;
+
+						const int end_z = z + 3 * dz;
+						const int end_y = y + 3 * dy;
+						const int end_x = x + 3 * dx;
+
+						if (end_z < 0 || end_z >= side || end_y < 0 || end_y >= side || end_x < 0 || end_x >= side)
+						{
+							continue;
+						}
+
+						std::uint64_t mask = 0;
+
+						for (int i = 0; i < side; ++i)
+						{
+							mask |= std::uint64_t{ 1 } << ((z + i * dz) * 16 + (y + i * dy) * 4 + x + i * dx);
+						}
+
+						lines[n_generated++] = mask;
+					}
+				}
+			}
+		}
+
+		return lines;
+	}
+
+	inline constexpr std::array<std::uint64_t, n_lines> lines = GenerateLines();
+
+	struct CellLines
+	{
+		std::array<std::uint8_t, max_cell_lines> lines_;
+		std::uint8_t size_;
+	};
+
+	// Indices into lines for every cell: 7 for the corners and the inner cube, 4 for the rest.
+	constexpr std::array<CellLines, n_cells> GenerateCellLines()
+	{
+		std::array<CellLines, n_cells> cell_lines = {};
+
+		for (int line = 0; line < n_lines; ++line)
+		{
+			for (int cell = 0; cell < n_cells; ++cell)
+			{
+				if ((lines[line] >> cell) & 1)
+				{
+					CellLines& entry = cell_lines[cell];
+					entry.lines_[entry.size_++] = static_cast<std::uint8_t>(line);
+				}
+			}
+		}
+
+		return cell_lines;
+	}
+
+	inline constexpr std::array<CellLines, n_cells> cell_lines = GenerateCellLines();
+
+	// Empty cells that would complete a line for own, i.e. lines holding three of own and none
+	// of other.
+	std::uint64_t WinningCells(std::uint64_t own, std::uint64_t other);
+} // namespace qubic
+
+class QubicPosition
+{
+private:
+	std::array<std::uint64_t, 2> stones_;
+	CellSymbol side_to_move_;
+	std::uint64_t hash_;
+
+public:
+	QubicPosition();
+
+	void Reset(CellSymbol side_to_move);
+
+	void MakeMove(std::size_t index);
+
+	void UnmakeMove(std::size_t index);
+
+	bool IsWinningMove(std::size_t index) const;
+
+	// Mask of the completed lines through index, 0 if there are none.
+	std::uint64_t WinningLines(std::size_t index) const;
+
+	CellSymbol At(std::size_t index) const;
+
+	std::uint64_t Stones(CellSymbol symbol) const;
+
+	std::uint64_t EmptyCells() const;
+
+	std::size_t FreeCells() const;
+
+	CellSymbol SideToMove() const;
+
+	std::uint64_t Hash() const;
+};
+
+// Alpha-beta with a transposition table, tuned for Qubic's 64-way branching. Threats are found
+// with line masks: a side with a winning cell wins at once, two open threats against the mover
+// lose, and a single one forces the block without using up depth, which keeps long forcing
+// sequences inside the horizon.
+class QubicSearch
+{
+private:
+	TranspositionTable transposition_table_;
+	std::array<int, qubic::n_cells> history_;
+	std::atomic<bool> stop_;
+	std::atomic<std::int64_t> deadline_;
+	std::uint64_t table_probes_;
+	std::uint64_t table_hits_;
+
+	int Negamax(QubicPosition& position, int depth, int ply, int alpha, int beta, int* best_move, std::uint64_t* nodes);
+
+	int Evaluate(const QubicPosition& position) const;
+
+public:
+	static constexpr int win_score = Search::win_score;
+	static constexpr int win_threshold = win_score - qubic::n_cells - 1;
+
+	explicit QubicSearch(std::size_t n_table_entries = constants::qubic_transposition_table_entries);
+
+	QubicSearch(const QubicSearch&) = delete;
+
+	QubicSearch& operator=(const QubicSearch&) = delete;
+
+	SearchResult Run(const QubicPosition& position, int max_depth);
+
+	void Stop();
+
+	void SetDeadline(std::chrono::steady_clock::time_point deadline);
+
+	void ClearDeadline();
+
+	void Clear();
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include "AI/Evaluator.hpp"
+#include "AI/Network.hpp"
+#include "AI/Position.hpp"
+#include "AI/TranspositionTable.hpp"
+#include "Utils/AllocationTracker.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SearchResult
+{
+	int best_move_;
+	int score_;
+	int depth_;
+	std::uint64_t nodes_;
+};
+
+// Lazy SMP: every thread runs its own iterative deepening on a private copy of the position
+// and they only cooperate through the shared transposition table. Helper threads visit the
+// moves in a rotated order so they fill the table with different subtrees than the main one.
+class Search
+{
+private:
+	// Written only by their own thread during a Run and summed once it is over; padded so the
+	// threads never share a cache line.
+	struct alignas(64) TableCounters
+	{
+		std::uint64_t probes_;
+		std::uint64_t hits_;
+	};
+
+	TranspositionTable transposition_table_;
+	const Evaluator* evaluator_;
+	const Network* network_;
+	bool network_active_;
+
+	// One accumulator per ply for every thread, so making a move fills the next slot from the
+	// current one and unmaking it costs nothing.
+	std::vector<nnue::Accumulator> accumulators_;
+	std::size_t n_threads_;
+	std::atomic<bool> stop_;
+	std::atomic<bool> helpers_stop_;
+	std::atomic<std::int64_t> deadline_;
+	std::atomic<std::uint64_t> helper_nodes_;
+	std::vector<TableCounters> table_counters_;
+	std::function<void(const SearchResult&)> iteration_callback_;
+
+	// Helpers live as long as the Search and are woken per Run, so a search creates no threads
+	// and allocates nothing.
+	std::vector<std::thread> helpers_;
+	std::mutex run_mutex_;
+	std::condition_variable run_condition_;
+	std::condition_variable done_condition_;
+	std::uint64_t generation_;
+	std::size_t helpers_running_;
+	bool shutting_down_;
+	const Position* run_position_;
+	int run_max_depth_;
+	std::atomic<std::uint64_t> helper_allocations_;
+	std::atomic<std::uint64_t> helper_allocated_bytes_;
+	AllocationStats last_run_allocations_;
+
+	void HelperLoop(std::size_t thread_index);
+
+	SearchResult IterativeDeepening(Position position, int max_depth, std::size_t thread_index);
+
+	int Negamax(Position& position, nnue::Accumulator* accumulator, int depth, int ply, int alpha, int beta, std::size_t thread_index, int* best_move, std::uint64_t* nodes);
+
+	bool Stopped(std::size_t thread_index) const;
+
+public:
+	static constexpr int win_score = 10000;
+	static constexpr int win_threshold = win_score - static_cast<int>(constants::max_board_cells);
+
+	explicit Search(std::size_t n_threads = 0, std::size_t n_table_entries = constants::ai_transposition_table_entries);
+
+	~Search();
+
+	Search(const Search&) = delete;
+
+	Search& operator=(const Search&) = delete;
+
+	SearchResult Run(const Position& position, int max_depth);
+
+	void Stop();
+
+	void SetDeadline(std::chrono::steady_clock::time_point deadline);
+
+	void ClearDeadline();
+
+	// Scores depth-limited leaves. Defaults to Evaluator::Default(); the table is not cleared, so
+	// call Clear() after switching evaluators.
+	void SetEvaluator(const Evaluator* evaluator);
+
+	// Replaces the evaluator on boards the network applies to. Defaults to Network::Default();
+	// same caveat about the table.
+	void SetNetwork(const Network* network);
+
+	void SetIterationCallback(std::function<void(const SearchResult&)> callback);
+
+	int TableMove(const Position& position) const;
+
+	void Clear();
+
+	std::size_t Threads() const;
+
+	// Heap allocations made by the last Run, main thread and helpers together.
+	AllocationStats LastRunAllocations() const;
+};
+
+#endif
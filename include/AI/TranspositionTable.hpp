@@ -0,0 +1,52 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum class Bound : std::uint8_t
+{
+	NONE, EXACT, LOWER, UPPER
+};
+
+struct TranspositionEntry
+{
+	int score_;
+	int best_move_;
+	int depth_;
+	Bound bound_;
+};
+
+// Lock-free table shared by all search threads. Every slot keeps the packed entry next to
+// the key XOR-ed with it, so a torn write from two racing threads simply fails verification.
+class TranspositionTable
+{
+private:
+	struct Slot
+	{
+		std::atomic<std::uint64_t> key_;
+		std::atomic<std::uint64_t> data_;
+	};
+
+	std::unique_ptr<Slot[]> slots_;
+	std::size_t mask_;
+
+	static std::uint64_t Pack(const TranspositionEntry& entry);
+
+	static TranspositionEntry Unpack(std::uint64_t data);
+
+public:
+	explicit TranspositionTable(std::size_t n_entries);
+
+	bool Probe(std::uint64_t key, TranspositionEntry* entry) const;
+
+	void Store(std::uint64_t key, const TranspositionEntry& entry);
+
+	void Clear();
+
+	std::size_t Size() const;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef ULTIMATE_HPP
+#define ULTIMATE_HPP
+
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/Constants.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ultimate tic-tac-toe: a 3x3 grid of 3x3 boards. A move is board * 9 + cell, and every board,
+// the big one included, is a 9-bit mask per side.
+namespace ultimate
+{
+	inline constexpr int n_boards = 9;
+	inline constexpr int n_moves = n_boards * 9;
+	inline constexpr std::uint16_t full_mask = 0x1FF;
+
+	// Rows, columns and diagonals of a 3x3 board as cell masks.
+	inline constexpr std::array<std::uint16_t, 8> lines = { 0007, 0070, 0700, 0111, 0222, 0444, 0421, 0124 };
+
+	// True for every 9-bit mask that holds a line.
+	constexpr std::array<bool, 512> GenerateWinningMasks()
+	{
+		std::array<bool, 512> winning = {};
+
+		for (int mask = 0; mask < 512; ++mask)
+		{
+			for (const std::uint16_t line : lines)
+			{
+				winning[mask] = winning[mask] || (mask & line) == line;
+			}
+		}
+
+		return winning;
+	}
+
+	inline constexpr std::array<bool, 512> winning_masks = GenerateWinningMasks();
+} // namespace ultimate
+
+class UltimatePosition
+{
+private:
+	std::array<std::array<std::uint16_t, ultimate::n_boards>, 2> cells_;
+
+	// Empty cells of the boards still in play and how many there are in total, kept up to date
+	// per move so random playouts pick a move without rescanning the boards.
+	std::array<std::uint16_t, ultimate::n_boards> open_cells_;
+	int n_open_cells_;
+
+	std::array<std::uint16_t, 2> boards_won_;
+	std::uint16_t boards_closed_;
+	int next_board_;
+	CellSymbol side_to_move_;
+	CellSymbol winner_;
+
+public:
+	UltimatePosition();
+
+	void Reset(CellSymbol side_to_move);
+
+	void MakeMove(int move);
+
+	bool IsLegal(int move) const;
+
+	// Fills moves with the legal moves and returns how many there are.
+	int LegalMoves(std::array<std::uint8_t, ultimate::n_moves>* moves) const;
+
+	// Uniformly random legal move; random is any 32-bit random number.
+	int RandomMove(std::uint32_t random) const;
+
+	bool IsOver() const;
+
+	// The side with three boards in a row, EMPTY while the game runs and for draws.
+	CellSymbol Winner() const;
+
+	CellSymbol BoardWinner(int board) const;
+
+	// Boards won by symbol as a 9-bit mask.
+	std::uint16_t BoardsWon(CellSymbol symbol) const;
+
+	// Empty cells of a board, 0 once the board is won or full.
+	std::uint16_t OpenCells(int board) const;
+
+	// The board the next move has to go to, -1 when any open board will do.
+	int NextBoard() const;
+
+	CellSymbol At(int move) const;
+
+	CellSymbol SideToMove() const;
+};
+
+// Monte Carlo tree search with UCT selection and uniformly random playouts. Nodes come from a
+// pool allocated once; a leaf is only expanded after a few visits so the pool lasts a whole
+// think, and once it is full the search carries on with playouts from the leaves. Independent
+// instances can search the same position on different threads (root parallelism) and their root
+// visits are summed by the caller.
+class UltimateSearch
+{
+private:
+	struct Node
+	{
+		std::uint32_t first_child_;
+		std::uint32_t visits_;
+		// Playout results for the side that made move_, a win counting 1 and a draw 1/2.
+		float wins_;
+		std::uint8_t n_children_;
+		std::uint8_t move_;
+	};
+
+	std::vector<Node> nodes_;
+	std::size_t n_nodes_;
+	std::uint64_t random_state_;
+	std::array<std::uint32_t, ultimate::n_moves> root_visits_;
+	std::array<float, ultimate::n_moves> root_wins_;
+	std::atomic<bool> stop_;
+	std::atomic<std::int64_t> deadline_;
+
+	std::uint32_t Random();
+
+	std::size_t SelectChild(const Node& node) const;
+
+	void Expand(Node* node, const UltimatePosition& position);
+
+	// Plays random moves to the end and returns the winner.
+	CellSymbol Playout(UltimatePosition position);
+
+public:
+	explicit UltimateSearch(std::size_t n_nodes = constants::ultimate_mcts_nodes, std::uint64_t seed = 1);
+
+	UltimateSearch(const UltimateSearch&) = delete;
+
+	UltimateSearch& operator=(const UltimateSearch&) = delete;
+
+	// Searches until the deadline or max_playouts. best_move_ is the most visited move, score_ its
+	// expected result for the side to move in per mille, depth_ the deepest node reached and
+	// nodes_ the number of playouts.
+	SearchResult Run(const UltimatePosition& position, std::uint64_t max_playouts);
+
+	// Visits and summed results per move of the last Run's root.
+	const std::array<std::uint32_t, ultimate::n_moves>& RootVisits() const;
+
+	const std::array<float, ultimate::n_moves>& RootWins() const;
+
+	void Stop();
+
+	void SetDeadline(std::chrono::steady_clock::time_point deadline);
+
+	void ClearDeadline();
+};
+
+#endif
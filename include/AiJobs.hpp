@@ -0,0 +1,52 @@
+#ifndef AI_JOBS_HPP
+#define AI_JOBS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+class Game;
+
+// Background AI searches of one state, run on the pool every state shares through Game. The
+// main thread leaves whatever the jobs read alone until Running() turns false, and Stop() cuts
+// them short through the searches' deadlines, so a state can leave at any time.
+class AiJobs
+{
+private:
+	Game* game_;
+	std::atomic<std::size_t> n_running_;
+
+	void Wait();
+
+public:
+	AiJobs();
+
+	void Attach(Game* game);
+
+	// Jobs receive a worker index below this, for per-worker searches.
+	std::size_t Workers() const;
+
+	void Submit(std::function<void(std::size_t)> job);
+
+	bool Running() const;
+
+	// searches is any range of pointers to searches with SetDeadline.
+	template <typename Searches>
+	void Stop(const Searches& searches);
+};
+
+template <typename Searches>
+void AiJobs::Stop(const Searches& searches)
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	for (const auto& search : searches)
+	{
+		search->SetDeadline(now);
+	}
+
+	Wait();
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef AUDIO_HPP
+#define AUDIO_HPP
+
+#include "Utils/LatencyHistogram.hpp"
+#include "Utils/SpscQueue.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class Sound
+{
+	PLACE, WIN, TIE
+};
+
+// Sound effects through SDL_mixer with a small device buffer. Every sound is decoded into the
+// device format when the device opens, so Play only hands a chunk already in memory to a free
+// channel: no I/O or decoding ever happens in the game loop. Without an audio device the game
+// simply stays silent.
+class Audio
+{
+private:
+	static constexpr std::size_t n_sounds = 3;
+
+	std::array<Mix_Chunk*, n_sounds> chunks_;
+	bool open_;
+	int frequency_;
+	int buffer_samples_;
+
+	// Performance counter of the click behind the last Play. The post-mix callback picks it up
+	// on the audio thread once the sound has been mixed and queues the latency for Report.
+	std::atomic<std::uint64_t> pending_click_;
+	SpscQueue<std::uint64_t, 64> click_to_mix_us_queue_;
+	LatencyHistogram click_to_mix_us_;
+
+	static void PostMix(void* user_data, Uint8* stream, int length);
+
+public:
+	Audio();
+
+	~Audio();
+
+	Audio(const Audio&) = delete;
+
+	Audio& operator=(const Audio&) = delete;
+
+	// Needs SDL's audio subsystem and the asset pack, if any, mounted.
+	bool Open();
+
+	void Close();
+
+	// Safe to call from any one thread at a time; click_counter is the click's InputStamp counter,
+	// or 0 for sounds nobody clicked for (AI moves).
+	void Play(Sound sound, std::uint64_t click_counter = 0);
+
+	void Report();
+};
+
+#endif
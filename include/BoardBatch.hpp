@@ -0,0 +1,51 @@
+#ifndef BOARD_BATCH_HPP
+#define BOARD_BATCH_HPP
+
+#include "BoardRenderer.hpp"
+#include "SpriteSheet.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <vector>
+
+// Draws many small boards with the BoardRenderer look in a single SDL_RenderGeometry call.
+// Symbols and a white block share one atlas texture, so cell backgrounds, win highlights and
+// symbols are all vertex-coloured quads from the same texture, queued in drawing order.
+class BoardBatch
+{
+private:
+	SDL_Renderer* renderer_;
+	SpriteSheet symbols_sheet_;
+	SDL_Texture* atlas_;
+	int cell_side_;
+	int separator_width_;
+
+	std::vector<SDL_Vertex> vertices_;
+	std::vector<int> indices_;
+
+	void AddQuad(float x, float y, float side, const SDL_Color& colour, float u0, float u1);
+
+public:
+	BoardBatch();
+
+	~BoardBatch();
+
+	// Reserves room for max_boards boards, so queuing a frame never allocates.
+	bool Initialize(SDL_Renderer* renderer, std::size_t max_boards);
+
+	// Rebuilds the atlas for the new cell size.
+	bool Layout(int cell_side, int separator_width);
+
+	int BoardSide() const;
+
+	void Begin();
+
+	void AddBoard(const BoardSnapshot& snapshot, int x, int y, float alpha);
+
+	void Submit();
+
+	void Free();
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BOARD_RENDERER_HPP
+#define BOARD_RENDERER_HPP
+
+#include "AI/Analysis.hpp"
+#include "AI/Position.hpp"
+#include "SpriteSheet.hpp"
+#include "Texture.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+enum class MessageType
+{
+	TIE, MENU, X_SCORE, O_SCORE
+};
+
+struct BoardSnapshot
+{
+	std::array<CellSymbol, 9> symbols_;
+	std::array<bool, 9> render_win_;
+	std::array<float, 9> symbol_fade_;
+	std::array<float, 9> symbol_fade_next_;
+	std::array<float, 9> win_fade_;
+	std::array<float, 9> win_fade_next_;
+	float transition_;
+	float transition_next_;
+	std::size_t free_cells_;
+	bool win_;
+	bool player_turn_;
+	int x_score_;
+	int o_score_;
+	bool analysis_;
+	std::uint64_t analysis_generation_;
+};
+
+// Draws a BoardSnapshot (board and score panel) with one SDL_Renderer. It owns every texture and
+// font it needs, so independent instances can draw on different threads, e.g. one software
+// renderer per worker when generating thumbnails.
+class BoardRenderer
+{
+private:
+	// SDL_ttf shares one FreeType library between all fonts and is not safe to call concurrently.
+	static std::mutex text_mutex_;
+
+	SDL_Renderer* renderer_;
+	TTF_Font* font_;
+
+	SpriteSheet symbols_sheet_;
+	std::vector<std::unique_ptr<Texture>> message_textures_;
+	std::array<SDL_Rect, 9> cell_rects_;
+	SDL_Rect board_viewport_;
+	SDL_Rect score_viewport_;
+	int cell_side_;
+	int info_symbol_side_;
+	int x_score_;
+	int o_score_;
+
+	bool LoadText(MessageType type, const char* text);
+
+public:
+	BoardRenderer();
+
+	~BoardRenderer();
+
+	bool Initialize(SDL_Renderer* renderer);
+
+	bool Layout(int width, int height, double ui_scale, int x_score, int o_score);
+
+	int CellAt(int x, int y) const;
+
+	// analysis, when given, must belong to the snapshot's position.
+	void Render(const BoardSnapshot& snapshot, float alpha, bool single_player, const AnalysisResult* analysis = nullptr);
+
+	void RenderBoard(const BoardSnapshot& snapshot, float alpha, const AnalysisResult* analysis = nullptr);
+	
+	void RenderInfo(const BoardSnapshot& snapshot, bool single_player);
+
+	void Free();
+};
+
+#endif
@@ -30,9 +30,11 @@ public:
 
 	void SetPosition(int x, int y);
 
+	void SetFont(TTF_Font* font);
+
 	void SetText(const std::string& text);
 	
-	std::string Text();
+	const std::string& Text() const;
 
 	bool MouseOver();
 
@@ -48,6 +50,8 @@ public:
 
 	void HandleEvent(SDL_Event* e);
 
+	bool LoadFromSurface(SDL_Surface* surface);
+
 	void Tick(bool force_update = false);
 
 	void Render(SDL_Renderer* renderer);
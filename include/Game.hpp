@@ -1,16 +1,21 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include "Audio.hpp"
 #include "Texture.hpp"
+#include "Utils/InputLatency.hpp"
+#include "Utils/ThreadPool.hpp"
 
 #include <SDL2/SDL.h>
 
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <stack>
 
 enum class GameMode
 {
-	NONE, SINGLE_PLAYER, MULTI_PLAYER
+	NONE, SINGLE_PLAYER, MULTI_PLAYER, EXHIBITION, QUBIC, ULTIMATE
 };
 
 class GameState;
@@ -24,11 +29,26 @@ private:
 	bool is_running_;
 	GameMode game_mode_;
 
+	double tick_rate_;
+	int max_catch_up_ticks_;
+	double smoothed_frame_time_;
+
+	std::chrono::steady_clock::time_point start_time_;
+
 	SDL_Window* window_;
 	SDL_Renderer* renderer_;
 
 	std::stack<GameState*> states_;
 
+	InputLatency input_latency_;
+
+	Audio audio_;
+
+	bool frame_may_allocate_;
+
+	// Shared by every state's AI (see AiJobs); states stop their jobs on Exit, before it is joined.
+	std::unique_ptr<ThreadPool> ai_pool_;
+
 public:
 	Game();
 
@@ -39,9 +59,32 @@ public:
 	SDL_Window* GetWindow();
 	
 	SDL_Renderer* GetRenderer();
+
+	InputLatency* GetInputLatency();
+
+	Audio* GetAudio();
+
+	// Created on first use with a worker per hardware thread.
+	ThreadPool* AiPool();
+
+	void UpdateScreenSize();
+
+	int ScreenWidth();
+
+	int ScreenHeight();
+
+	double UiScale();
+
+	void WindowToRenderer(int* x, int* y);
 	
 	[[nodiscard]] bool Initialize();
 
+	// Exempts the current frame from the zero-allocation check (state changes, relayout, etc.).
+	void AllowFrameAllocations();
+
+	// Prints the time since the Game was constructed, for tracking startup latency.
+	void MarkStartup(const char* milestone);
+
 	void ChangeState(GameState* state);
 
 	void PushState(GameState* state);
@@ -55,6 +98,16 @@ public:
 	void Stop();
 
 	void SetGameMode(enum GameMode mode);
+
+	// Startup option (--tick-rate) only: the simulation thread reads it without synchronization.
+	void SetTickRate(double tick_rate);
+
+	// At least one tick, so a duration never vanishes at low tick rates.
+	int SecondsToTicks(double seconds) const;
+
+	void SetMaxCatchUpTicks(int max_catch_up_ticks);
+
+	int MaxCatchUpTicks() const;
 	
 	GameMode GameMode();
 
@@ -62,7 +115,7 @@ public:
 
 	void Tick();
 
-	void Render();
+	void Render(double alpha);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef ENGINE_MODE_HPP
+#define ENGINE_MODE_HPP
+
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Gomocup-style text protocol on stdin/stdout (START, BEGIN, TURN, BOARD, INFO, RESTART, END)
+// extended with UCI-like pondering: after answering, the engine searches the predicted reply
+// until PONDERHIT / a matching TURN arrives, or STOP / a different TURN discards it.
+class EngineProtocol
+{
+private:
+	Position position_;
+	std::unique_ptr<Search> search_;
+	std::thread search_thread_;
+	std::mutex mutex_;
+	std::mutex output_mutex_;
+	std::condition_variable ponder_condition_;
+
+	bool running_;
+	bool ponder_enabled_;
+	bool pondering_;
+	bool ponder_hit_;
+	bool stop_requested_;
+	std::atomic<bool> quitting_;
+	int ponder_move_;
+	int max_depth_;
+	std::size_t n_threads_;
+	std::int64_t timeout_turn_ms_;
+	std::int64_t time_left_ms_;
+	std::chrono::steady_clock::time_point search_start_;
+
+	void HandleCommand(const std::string& command, const std::string& arguments, std::istream& in);
+
+	void HandleInfo(const std::string& arguments);
+
+	void HandleTurn(int index);
+
+	void ReadBoard(std::istream& in);
+
+	void StartThinking();
+
+	void StopSearch();
+
+	void SearchLoop(Position position, bool ponder);
+
+	bool ParseMove(const std::string& text, int* index, int* who = nullptr) const;
+
+	std::chrono::milliseconds MoveBudget(const Position& position) const;
+
+	void Send(const std::string& line);
+
+	// Runs on the search thread, so it is handed the board dimension rather than reading position_.
+	void SendInfo(const SearchResult& result, std::size_t board_dim);
+
+public:
+	EngineProtocol();
+
+	~EngineProtocol();
+
+	int Run(std::istream& in);
+};
+
+int RunEngineMode();
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef RENDER_MODE_HPP
+#define RENDER_MODE_HPP
+
+// Headless board renderer: ./output --render <out_dir> [--threads N] [--size WxH] [--format png|raw|none] [--repeat N]
+// Reads one board per line from stdin ("XO.X..O.." row-major, optionally followed by the X and O
+// scores) and draws each with a software renderer, writing <out_dir>/board_NNNNNN.<png|rgba>.
+int RunRenderMode(int argc, char* argv[]);
+
+#endif
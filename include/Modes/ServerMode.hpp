@@ -0,0 +1,10 @@
+#ifndef SERVER_MODE_HPP
+#define SERVER_MODE_HPP
+
+// Headless game server: ./output --server [port] [workers]
+int RunServerMode(int argc, char* argv[]);
+
+// Loopback load generator: ./output --server-load [port] [connections] [sessions_per_connection] [seconds] [dimension] [k]
+int RunLoadClientMode(int argc, char* argv[]);
+
+#endif
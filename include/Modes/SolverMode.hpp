@@ -0,0 +1,8 @@
+#ifndef SOLVER_MODE_HPP
+#define SOLVER_MODE_HPP
+
+// Offline solver: ./output --solve <dimension> <n_symbols_to_win> [--first X|O] [--memory MB]
+//                                  [--checkpoint PATH] [--interval NODES] [--proof PATH]
+int RunSolverMode(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef TRAINING_MODE_HPP
+#define TRAINING_MODE_HPP
+
+// Deterministic headless workload used to collect PGO profiles and to time optimized builds:
+// ./output --train [rounds]
+// Exercises the search, win detection and the software render path, then prints per-phase
+// timings and a checksum that must match across builds.
+int RunTrainingMode(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef TUNE_MODE_HPP
+#define TUNE_MODE_HPP
+
+// Offline Texel tuner for the pattern evaluator:
+// ./output --tune [--games N] [--depth D] [--load PATH] [--save PATH] [--epochs N] [--rate R] [--output PATH]
+// Generates self-play positions on every core (and/or loads recorded ones), fits the logistic
+// scale, then tunes the weights by batch gradient descent and writes them to --output.
+int RunTuneMode(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef GAME_SERVER_HPP
+#define GAME_SERVER_HPP
+
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Server/Protocol.hpp"
+#include "Utils/LatencyHistogram.hpp"
+#include "Utils/ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Headless host for many independent games: one epoll loop owns every connection and session,
+// AI moves run on a worker pool and come back through an eventfd-signalled completion queue.
+class GameServer
+{
+private:
+	struct Session
+	{
+		Position position_;
+		int fd_;
+		bool busy_;
+		std::chrono::steady_clock::time_point request_time_;
+	};
+
+	struct Connection
+	{
+		std::string input_;
+		std::string output_;
+		std::vector<std::uint32_t> sessions_;
+		bool writing_;
+	};
+
+	struct Completion
+	{
+		std::uint32_t session_id_;
+		int move_;
+	};
+
+	int listen_fd_;
+	int epoll_fd_;
+	int event_fd_;
+	std::atomic<bool> running_;
+
+	std::unordered_map<int, Connection> connections_;
+	std::unordered_map<std::uint32_t, Session> sessions_;
+	std::uint32_t next_session_id_;
+
+	std::unique_ptr<ThreadPool> pool_;
+	std::vector<std::unique_ptr<Search>> searches_;
+	std::mutex completions_mutex_;
+	std::vector<Completion> completions_;
+	std::vector<Completion> completions_swap_;
+
+	LatencyHistogram move_latency_us_;
+	std::uint64_t moves_;
+	std::uint64_t games_;
+	std::chrono::steady_clock::time_point last_report_;
+
+	void Accept();
+
+	void ReadConnection(int fd);
+
+	void FlushConnection(int fd);
+
+	void CloseConnection(int fd);
+
+	void HandleFrame(int fd, const char* frame);
+
+	void HandleNew(int fd, const char* frame);
+
+	void HandleMove(int fd, const char* frame);
+
+	void HandleClose(int fd, const char* frame);
+
+	void RequestAiMove(std::uint32_t session_id, Session& session);
+
+	void DrainCompletions();
+
+	void SendSession(int fd, std::uint32_t session_id);
+
+	void SendMoveResult(int fd, std::uint32_t session_id, std::uint16_t cell, protocol::Status status);
+
+	void SendError(int fd, std::uint32_t session_id, protocol::ErrorCode code);
+
+	void Report();
+
+	static protocol::Status GameStatus(const Position& position, int last_move);
+
+public:
+	explicit GameServer(std::size_t n_workers = 0);
+
+	~GameServer();
+
+	bool Listen(std::uint16_t port);
+
+	void Run();
+
+	void Stop();
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef METRICS_EXPORTER_HPP
+#define METRICS_EXPORTER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Background thread that renders Metrics every export interval. The text goes to a file, replaced
+// atomically so node_exporter's textfile collector never reads half of it, and/or is served over
+// HTTP on 127.0.0.1 (`GET /metrics`). Scrapes get the last rendered text, so they never reset the
+// histogram windows themselves and the game loop is never involved.
+class MetricsExporter
+{
+private:
+	std::string path_;
+	int listen_fd_;
+	int wake_fd_;
+	std::chrono::milliseconds interval_;
+	std::thread thread_;
+	std::string text_;
+
+	void Loop();
+
+	void Export();
+
+	void Serve();
+
+public:
+	MetricsExporter();
+
+	~MetricsExporter();
+
+	MetricsExporter(const MetricsExporter&) = delete;
+
+	MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+	// Either destination may be left out with an empty path or port 0.
+	bool Start(const std::string& path, std::uint16_t port, std::chrono::milliseconds interval);
+
+	void Stop();
+};
+
+#endif
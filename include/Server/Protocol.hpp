@@ -0,0 +1,60 @@
+#ifndef PROTOCOL_HPP
+#define PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Fixed-size little-endian frames. The first byte is the opcode, the payload size follows from it.
+//   client -> server: NEW [dimension u8][k u8][ai_first u8], MOVE [session u32][cell u16], CLOSE [session u32]
+//   server -> client: SESSION [session u32], MOVE_RESULT [session u32][cell u16][status u8], ERROR [session u32][code u8]
+namespace protocol
+{
+	enum class Opcode : std::uint8_t
+	{
+		NEW = 0x01, MOVE = 0x02, CLOSE = 0x03, SESSION = 0x81, MOVE_RESULT = 0x82, ERROR = 0xFF
+	};
+
+	enum class Status : std::uint8_t
+	{
+		ONGOING, X_WINS, O_WINS, DRAW
+	};
+
+	enum class ErrorCode : std::uint8_t
+	{
+		UNKNOWN_OPCODE, UNKNOWN_SESSION, INVALID_MOVE, NOT_YOUR_TURN, INVALID_BOARD
+	};
+
+	inline constexpr std::uint16_t no_cell = 0xFFFF;
+
+	inline constexpr std::size_t FrameSize(std::uint8_t opcode)
+	{
+		switch (static_cast<Opcode>(opcode))
+		{
+			case Opcode::NEW: return 4;
+			case Opcode::MOVE: return 7;
+			case Opcode::CLOSE: return 5;
+			case Opcode::SESSION: return 5;
+			case Opcode::MOVE_RESULT: return 8;
+			case Opcode::ERROR: return 6;
+		}
+
+		return 0;
+	}
+
+	template<typename T>
+	inline T Read(const char* data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+	template<typename T>
+	inline void Write(char* data, T value)
+	{
+		std::memcpy(data, &value, sizeof(T));
+	}
+} // namespace protocol
+
+#endif
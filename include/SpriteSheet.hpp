@@ -0,0 +1,43 @@
+#ifndef SPRITE_SHEET_HPP
+#define SPRITE_SHEET_HPP
+
+#include "Texture.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Horizontal strip of square sprites kept on the CPU as a mip chain. Textures are generated once
+// per requested sprite size (filtered down from the closest larger level) and cached, so drawing
+// never rescales on the GPU and small sizes stay smooth instead of nearest-sampled. Every filter
+// works sprite by sprite, so neighbouring sprites never bleed into each other.
+class SpriteSheet
+{
+private:
+	std::vector<SDL_Surface*> mip_levels_;
+	std::vector<std::pair<int, std::unique_ptr<Texture>>> cache_;
+	int n_sprites_;
+
+	static SDL_Surface* Downscale(SDL_Surface* source, int n_sprites);
+
+	static SDL_Surface* Resample(SDL_Surface* source, int n_sprites, int sprite_size);
+
+public:
+	SpriteSheet();
+
+	~SpriteSheet();
+
+	bool Load(const char* name, int n_sprites);
+
+	Texture* Get(SDL_Renderer* renderer, int sprite_size);
+
+	SDL_Rect Clip(int index, int sprite_size) const;
+
+	void ClearCache();
+
+	void Free();
+};
+
+#endif
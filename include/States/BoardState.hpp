@@ -1,45 +1,78 @@
 #ifndef BOARD_STATE_HPP
 #define BOARD_STATE_HPP
 
+#include "AI/Analysis.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
 #include "States/GameState.hpp"
-#include "Texture.hpp"
+#include "BoardRenderer.hpp"
+#include "Utils/InputLatency.hpp"
+#include "Utils/SpscQueue.hpp"
+#include "Utils/TripleBuffer.hpp"
+#include "Utils/TweenPool.hpp"
 
 #include <SDL2/SDL.h>
 
 #include <memory>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 class Game;
 
-enum class CellSymbol
-{
-	EMPTY, X, O
-};
-
 struct Cell
 {
 	CellSymbol symbol_;
-	SDL_Rect rect_;
 	bool render_win_;
+	TweenHandle fade_tween_;
+	TweenHandle win_tween_;
 };
 
-enum class MessageType
+// Moves played since the last reset. Undo only moves size_ back, so undone moves stay above it
+// for redo until a new move overwrites them.
+struct MoveHistory
 {
-	TIE, MENU, X_SCORE, O_SCORE
+	std::array<std::size_t, 9> moves_;
+	std::size_t size_;
+	std::size_t redo_size_;
 };
 
 struct Board
 {
 	std::array<Cell, 9> grid_;
+	MoveHistory history_;
 	std::size_t dimension_;
 	std::size_t free_cells_;
 	std::size_t n_symbols_to_win_;
 	
 	int clicked_cell_index_;
+	InputStamp clicked_stamp_;
 	bool win_;
 	CellSymbol win_symbol_;
 	bool reset_;
+	InputStamp reset_stamp_;
+};
+
+enum class BoardCommandType
+{
+	CLICK, ANALYSIS, UNDO, REDO
+};
+
+struct BoardCommand
+{
+	BoardCommandType type_;
+	int cell_;
+	InputStamp stamp_;
+};
+
+struct ConsumedInput
+{
+	InputStamp stamp_;
+	std::uint64_t consumed_counter_;
 };
 
 class BoardState : public GameState
@@ -49,45 +82,118 @@ private:
 	
 	Board board_;
 
+	// Mirrors grid_ and the side to move, so hashes and win checks around the last move are
+	// updated per move instead of rescanning the board.
+	Position position_;
+
 	bool player_turn_;
 	int x_score_;
 	int o_score_;
 	bool single_player_;
 
-	TTF_Font* font_;
 	Game* game_;
 
-	std::unique_ptr<Texture> symbols_texture_;
-	std::vector<std::unique_ptr<Texture>> message_textures_;
-	SDL_Rect symbols_sprites_clips_[2];
-	SDL_Rect board_viewport_;
-	SDL_Rect score_viewport_;
+	std::unique_ptr<Search> search_;
+	bool pondering_;
+
+	// Lives from Enter to Exit and is woken per turn, so pondering creates no threads and
+	// allocates nothing. ponder_running_ stays set until the requested search has returned.
+	std::thread ponder_thread_;
+	std::mutex ponder_mutex_;
+	std::condition_variable ponder_condition_;
+	Position ponder_position_;
+	bool ponder_requested_;
+	bool ponder_running_;
+	bool ponder_exiting_;
+
+	// Heatmap of every empty cell's value, toggled with A. Created on the main thread the first
+	// time it is switched on; positions are submitted from the simulation thread.
+	std::unique_ptr<Analysis> analysis_;
+	bool analysis_enabled_;
+	std::uint64_t analysis_generation_;
+	std::uint64_t analysed_hash_;
+
+	// Game logic, AI included, runs on simulation_thread_. The main thread only forwards input
+	// through commands_ and draws the latest snapshot, so a slow tick never delays a frame. Ticks
+	// are only counted, so a long AI move cannot fill the queue; input that still does not fit
+	// waits in overflow_commands_ (main thread only) rather than being dropped.
+	SpscQueue<BoardCommand, 256> commands_;
+	std::vector<BoardCommand> overflow_commands_;
+	std::atomic<std::uint64_t> pending_ticks_;
+	std::uint64_t simulated_ticks_;
+	SpscQueue<ConsumedInput, 64> consumed_inputs_;
+	TripleBuffer<BoardSnapshot> snapshots_;
+	std::array<ConsumedInput, 16> pending_consumed_inputs_;
+	std::size_t n_pending_consumed_inputs_;
+	std::thread simulation_thread_;
+	std::atomic<bool> simulating_;
+	std::mutex wake_mutex_;
+	std::condition_variable wake_condition_;
+
+	TweenPool tweens_;
+	TweenHandle transition_tween_;
+
+	// Layout and textures follow the renderer size and are only touched on the main thread; the
+	// simulation thread sees clicks as cell indices.
+	BoardRenderer board_renderer_;
 
 	void InitBoard();
-	
-	bool InitSymbolsTexture();
-	
-	bool InitMessageTextures();
+
+	bool Layout();
 
 	void ResetBoard();
 
-	void RenderBoard();
-	
-	void RenderInfo();
+	void StartSimulation();
 
-	void SetClickedCellIndex();
+	void StopSimulation();
 
-	bool CheckWin(bool set_render_win_flag = true, CellSymbol* winning_symbol = nullptr);
+	void SimulationLoop();
 
-	bool CheckRowsColsWin(bool set_render_win_flag = true, CellSymbol* winning_symbol = nullptr);
-	
-	bool CheckDiagonalsWin(bool set_render_win_flag = true, CellSymbol* winning_symbol = nullptr);
+	void PushCommand(const BoardCommand& command);
 
-	bool CheckSymbolsWin(std::size_t index, std::vector<std::size_t>* winning_indices, bool set_render_win_flag = true, CellSymbol* winning_symbol = nullptr);
+	// Moves overflowed commands into the queue in order; false while some are still waiting.
+	bool FlushOverflowCommands();
+
+	void HandleClick(const BoardCommand& command);
+
+	void Step();
+
+	void PlaceSymbol(std::size_t index, CellSymbol symbol);
+
+	// Plays index for the side to move and records it; redo replays a recorded move instead of
+	// starting a new line.
+	void MakeMove(std::size_t index, bool redo = false);
+
+	// Placement, win or tie sound for the move just made; click_counter is 0 for AI moves.
+	void PlayMoveSound(std::uint64_t click_counter);
+
+	bool UndoMove();
+
+	bool RedoMove();
+
+	// In single player a takeback spans the AI's reply too, so the human is to move again.
+	void Undo();
+
+	void Redo();
+
+	void ConsumeInput(const InputStamp& stamp);
+
+	void PublishSnapshot();
+
+	void UpdateAnalysis();
+
+	void SetClickedCellIndex(int cell, const InputStamp& stamp);
+
+	// Marks the first complete line from the engine's compile-time table.
+	bool CheckWin(bool set_render_win_flag = true, CellSymbol* winning_symbol = nullptr);
 
 	int BestMove();
 
-	int Minimax(int depth, bool is_maximizing);
+	void PonderLoop();
+
+	void StartPondering();
+
+	void StopPondering();
 
 public:
 	BoardState() = default;
@@ -106,7 +212,9 @@ public:
 	
 	void Tick();
 	
-	void Render();
+	void Render(double alpha);
+
+	bool TicksOnMainThread() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef EXHIBITION_STATE_HPP
+#define EXHIBITION_STATE_HPP
+
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "States/GameState.hpp"
+#include "AiJobs.hpp"
+#include "BoardBatch.hpp"
+#include "BoardRenderer.hpp"
+#include "Utils/Constants.hpp"
+#include "Utils/TweenPool.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+class Game;
+
+// One AI-vs-AI game of the exhibition. The main thread owns everything except chosen_move_,
+// which an AI pool worker stores once its search returns; until then it is -1 and the position
+// is only read.
+struct ExhibitionGame
+{
+	Position position_;
+	std::array<int, 9> placed_tick_;
+	std::array<bool, 9> render_win_;
+	int win_tick_;
+	int next_tick_;
+	std::size_t n_random_moves_;
+	bool over_;
+
+	bool awaiting_move_;
+	std::atomic<int> chosen_move_;
+};
+
+// Grid of independent AI-vs-AI games for event displays. Every game's AI runs on the game's AI
+// pool (a Search per worker) and all boards are drawn by a single BoardBatch submission.
+class ExhibitionState : public GameState
+{
+private:
+	static std::unique_ptr<ExhibitionState> exhibition_state_;
+
+	Game* game_;
+
+	std::size_t n_boards_ = constants::exhibition_boards;
+	std::array<ExhibitionGame, constants::exhibition_max_boards> games_;
+	std::array<SDL_Point, constants::exhibition_max_boards> board_origins_;
+	BoardSnapshot snapshot_;
+	int tick_;
+	std::mt19937 random_;
+
+	std::vector<std::unique_ptr<Search>> searches_;
+	AiJobs jobs_;
+
+	BoardBatch board_batch_;
+
+	TweenPool tweens_;
+	TweenHandle transition_tween_;
+
+	bool Layout();
+
+	void ResetGame(ExhibitionGame* game);
+
+	void PlayMove(ExhibitionGame* game, std::size_t index);
+
+	void StartThinking(std::size_t game_index);
+
+	void StopThinking();
+
+	void FillSnapshot(const ExhibitionGame& game);
+
+public:
+	ExhibitionState() = default;
+
+	static ExhibitionState* Instance();
+
+	// Clamped to [exhibition_min_boards, exhibition_max_boards]; takes effect on the next Enter.
+	void SetBoards(std::size_t n_boards);
+
+	bool Enter(Game* game);
+
+	void Exit();
+
+	void Pause();
+
+	void Resume();
+
+	void HandleEvents();
+
+	void Tick();
+
+	void Render(double alpha);
+};
+
+#endif
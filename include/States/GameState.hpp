@@ -14,13 +14,34 @@ public:
 
 	virtual void HandleEvents() = 0;
 	virtual void Tick() = 0;
-	virtual void Render() = 0;
+	virtual void Render(double alpha) = 0;
+
+	// False for states whose Tick only hands the tick to a simulation thread; they record the
+	// tick time metric where the tick really runs.
+	virtual bool TicksOnMainThread() const
+	{
+		return true;
+	}
 
 	void ChangeState(Game* game, GameState* state)
 	{
 		game->ChangeState(state);
 	}
 
+	void RenderTransition(SDL_Renderer* renderer, float progress)
+	{
+		if (progress >= 1.0f)
+		{
+			return;
+		}
+
+		SDL_RenderSetViewport(renderer, NULL);
+		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+		SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, static_cast<Uint8>((1.0f - progress) * 0xFF));
+		SDL_RenderFillRect(renderer, NULL);
+		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	}
+
 	virtual ~GameState()
 	{
 	}
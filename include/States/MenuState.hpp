@@ -4,14 +4,25 @@
 #include "Button.hpp"
 #include "States/GameState.hpp"
 #include "Texture.hpp"
+#include "Utils/TweenPool.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
+#include <future>
+#include <string>
 #include <vector>
 
 class Game;
 
+// CPU-side menu resources, decoded and rasterized off the render thread.
+struct MenuAssets
+{
+	SDL_Surface* title_surface_;
+	TTF_Font* font_;
+	std::vector<SDL_Surface*> label_surfaces_;
+};
+
 class MenuState : public GameState
 {
 private:
@@ -23,7 +34,24 @@ private:
 	std::unique_ptr<Texture> title_texture_;
 	std::vector<std::unique_ptr<Button>> menu_buttons_;
 
-	bool InitTextures();
+	TweenPool tweens_;
+	TweenHandle transition_tween_;
+
+	double title_scale_;
+	int title_y_;
+
+	std::future<MenuAssets> pending_assets_;
+	bool assets_ready_;
+
+	static MenuAssets LoadAssets(double ui_scale, std::vector<std::string> texts);
+
+	static void FreeAssets(MenuAssets* assets);
+
+	bool FinishLoading();
+
+	bool Layout();
+
+	void PositionElements();
 
 public:
 	MenuState() = default;
@@ -42,7 +70,7 @@ public:
 	
 	void Tick();
 	
-	void Render();
+	void Render(double alpha);
 };
 
 #endif
\ No newline at end of file
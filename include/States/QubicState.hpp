@@ -0,0 +1,84 @@
+#ifndef QUBIC_STATE_HPP
+#define QUBIC_STATE_HPP
+
+#include "AI/Qubic.hpp"
+#include "States/GameState.hpp"
+#include "AiJobs.hpp"
+#include "SpriteSheet.hpp"
+#include "Utils/TweenPool.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+class Game;
+
+// 4x4x4 tic-tac-toe against the AI, drawn as four stacked layers. The human plays X and the
+// first move alternates between games. The AI thinks on the game's AI pool so frames keep coming
+// while it searches; it only reads the position, which the main thread leaves alone while jobs_
+// is running.
+class QubicState : public GameState
+{
+private:
+	static std::unique_ptr<QubicState> qubic_state_;
+
+	Game* game_;
+
+	QubicPosition position_;
+	CellSymbol first_symbol_;
+	std::array<int, qubic::n_cells> placed_tick_;
+	std::uint64_t win_cells_;
+	int win_tick_;
+	int tick_;
+	bool over_;
+
+	std::unique_ptr<QubicSearch> search_;
+	AiJobs jobs_;
+	bool awaiting_move_;
+	std::chrono::steady_clock::time_point think_start_;
+	int chosen_move_;
+
+	SpriteSheet symbols_sheet_;
+	std::array<SDL_Rect, qubic::n_cells> cell_rects_;
+	int cell_side_;
+
+	TweenPool tweens_;
+	TweenHandle transition_tween_;
+
+	void Layout();
+
+	void NewGame();
+
+	// click_counter is the click's InputStamp counter, or 0 for the AI's moves.
+	void PlayMove(std::size_t index, std::uint64_t click_counter = 0);
+
+	int CellAt(int x, int y) const;
+
+	void StartThinking();
+
+	void StopThinking();
+
+public:
+	QubicState() = default;
+
+	static QubicState* Instance();
+
+	bool Enter(Game* game);
+
+	void Exit();
+
+	void Pause();
+
+	void Resume();
+
+	void HandleEvents();
+
+	void Tick();
+
+	void Render(double alpha);
+};
+
+#endif
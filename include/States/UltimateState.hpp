@@ -0,0 +1,91 @@
+#ifndef ULTIMATE_STATE_HPP
+#define ULTIMATE_STATE_HPP
+
+#include "AI/Ultimate.hpp"
+#include "States/GameState.hpp"
+#include "AiJobs.hpp"
+#include "SpriteSheet.hpp"
+#include "Utils/TweenPool.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Game;
+
+// Ultimate tic-tac-toe against the AI. The human plays X and the first move alternates between
+// games. Every AI pool worker runs its own MCTS on the position (root parallelism) and the move
+// with the most visits over all of them is played; the position is only read while jobs_ is
+// running.
+class UltimateState : public GameState
+{
+private:
+	static std::unique_ptr<UltimateState> ultimate_state_;
+
+	Game* game_;
+
+	UltimatePosition position_;
+	CellSymbol first_symbol_;
+	std::array<int, ultimate::n_moves> placed_tick_;
+	std::array<int, ultimate::n_boards> board_won_tick_;
+	std::uint16_t winning_boards_;
+	int win_tick_;
+	int tick_;
+	bool over_;
+
+	std::vector<std::unique_ptr<UltimateSearch>> searches_;
+	AiJobs jobs_;
+	bool awaiting_move_;
+	std::chrono::steady_clock::time_point think_start_;
+
+	SpriteSheet symbols_sheet_;
+	std::array<SDL_Rect, ultimate::n_moves> cell_rects_;
+	std::array<SDL_Rect, ultimate::n_boards> board_rects_;
+	int cell_side_;
+	int board_side_;
+	int highlight_width_;
+
+	TweenPool tweens_;
+	TweenHandle transition_tween_;
+
+	void Layout();
+
+	void NewGame();
+
+	// click_counter is the click's InputStamp counter, or 0 for the AI's moves.
+	void PlayMove(int move, std::uint64_t click_counter = 0);
+
+	int CellAt(int x, int y) const;
+
+	void StartThinking();
+
+	void StopThinking();
+
+	// Most visited root move summed over every worker's search.
+	int ChosenMove() const;
+
+public:
+	UltimateState() = default;
+
+	static UltimateState* Instance();
+
+	bool Enter(Game* game);
+
+	void Exit();
+
+	void Pause();
+
+	void Resume();
+
+	void HandleEvents();
+
+	void Tick();
+
+	void Render(double alpha);
+};
+
+#endif
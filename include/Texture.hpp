@@ -18,12 +18,14 @@ public:
 
 	void FreeTexture();
 
-	bool LoadFromPath(SDL_Renderer* renderer, const char* path);
+	bool LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
 
 	bool LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* text, const SDL_Color& text_color);
 
 	void Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip = NULL, double scale = 1.0);
 
+	void SetAlpha(Uint8 alpha);
+
 	int Width() const;
 	
 	int Height() const;
@@ -0,0 +1,39 @@
+#ifndef ALLOCATION_TRACKER_HPP
+#define ALLOCATION_TRACKER_HPP
+
+#include <cstdint>
+
+struct AllocationStats
+{
+	std::uint64_t allocations_;
+	std::uint64_t bytes_;
+};
+
+// Counts every global operator new. Counters are kept per thread, so a scope measures only the
+// work done by the thread it lives on and the hot path never touches shared memory.
+class AllocationTracker
+{
+public:
+	static AllocationStats ThreadTotals();
+
+	// Strict mode makes ExpectNone report and assert on any allocation in a scope that is meant
+	// to be allocation-free (steady-state frames and searches).
+	static void SetStrict(bool strict);
+
+	static bool Strict();
+
+	static void ExpectNone(const char* what, const AllocationStats& stats);
+};
+
+class AllocationScope
+{
+private:
+	AllocationStats start_;
+
+public:
+	AllocationScope();
+
+	AllocationStats Stats() const;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef ASSET_PACK_HPP
+#define ASSET_PACK_HPP
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only archive of every file under res/, built by `./output --pack-assets` and memory-mapped
+// at startup. Images are stored already decoded as RGBA32 (magenta color key turned into alpha),
+// so loading one is a pointer into the mapping rather than a PNG decode. Assets are looked up by
+// their path relative to res/; without a pack they are read from res/ next to the executable.
+class AssetPack
+{
+private:
+	enum class EntryType : std::uint32_t
+	{
+		FILE, PIXELS
+	};
+
+	struct Entry
+	{
+		char name_[48];
+		EntryType type_;
+		std::uint32_t width_;
+		std::uint32_t height_;
+		std::uint32_t pitch_;
+		std::uint64_t offset_;
+		std::uint64_t size_;
+	};
+
+	struct Header
+	{
+		char magic_[4];
+		std::uint32_t n_entries_;
+	};
+
+	static constexpr char magic[4] = { 'T', 'P', 'K', '1' };
+
+	const unsigned char* data_;
+	std::size_t size_;
+	const Entry* entries_;
+	std::uint32_t n_entries_;
+	std::string base_path_;
+
+	AssetPack();
+
+	const Entry* Find(const char* name) const;
+
+	static SDL_Surface* DecodeImage(const char* path);
+
+public:
+	~AssetPack();
+
+	AssetPack(const AssetPack&) = delete;
+
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	static AssetPack& Instance();
+
+	// Not thread-safe; call once before any asset is loaded.
+	bool Mount(const char* pack_name = "assets.pak");
+
+	void Unmount();
+
+	bool Mounted() const;
+
+	// Returns an RGBA32 surface the caller frees with SDL_FreeSurface. Surfaces backed by the pack
+	// point straight into the read-only mapping and must not be written to.
+	SDL_Surface* LoadSurface(const char* name) const;
+
+	TTF_Font* OpenFont(const char* name, int point_size) const;
+
+	// Decodes a sound into the open audio device's format; free it with Mix_FreeChunk.
+	Mix_Chunk* LoadChunk(const char* name) const;
+
+	static bool Build(const char* res_dir, const char* output_path);
+};
+
+#endif
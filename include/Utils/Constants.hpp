@@ -1,11 +1,56 @@
 #ifndef CONSTANTS_HPP
 #define CONSTANTS_HPP
 
+#include <cstddef>
+#include <cstdint>
+
 namespace constants
 {
 	inline constexpr char game_title[] = "TicTacToe"; 
 	inline constexpr int screen_width = 720;
 	inline constexpr int screen_height = 960;
+
+	inline constexpr double default_tick_rate = 60.0;
+	inline constexpr int max_catch_up_ticks = 5;
+	inline constexpr double max_frame_time = 0.25;
+	inline constexpr double frame_time_smoothing = 0.2;
+	inline constexpr int allocation_warmup_frames = 120;
+
+	// Animation and pacing durations are in seconds and turned into ticks at the configured tick
+	// rate (Game::SecondsToTicks), so --tick-rate changes simulation granularity, not game speed.
+	inline constexpr double symbol_fade_seconds = 0.2;
+	inline constexpr double win_sweep_seconds = 0.17;
+	inline constexpr double win_sweep_delay_seconds = 0.1;
+	inline constexpr double transition_seconds = 0.33;
+
+	// 256 samples at 48 kHz keep the device buffer around 5 ms.
+	inline constexpr int audio_frequency = 48000;
+	inline constexpr int audio_buffer_samples = 256;
+	inline constexpr int audio_channels = 8;
+
+	inline constexpr std::size_t max_board_dimension = 15;
+	inline constexpr std::size_t max_board_cells = max_board_dimension * max_board_dimension;
+
+	inline constexpr int metrics_export_milliseconds = 10000;
+
+	inline constexpr int ai_search_depth = 3;
+	inline constexpr std::size_t ai_transposition_table_entries = 1 << 16;
+	inline constexpr std::size_t nnue_min_board_dimension = 15;
+	inline constexpr int analysis_max_depth = 12;
+
+	inline constexpr std::size_t exhibition_boards = 36;
+	inline constexpr std::size_t exhibition_min_boards = 16;
+	inline constexpr std::size_t exhibition_max_boards = 64;
+	inline constexpr double exhibition_move_seconds = 0.4;
+	inline constexpr double exhibition_result_seconds = 2.0;
+
+	inline constexpr std::size_t qubic_transposition_table_entries = 1 << 20;
+	inline constexpr int qubic_think_milliseconds = 1500;
+	inline constexpr int qubic_max_depth = 64;
+
+	inline constexpr std::size_t ultimate_mcts_nodes = 1 << 21;
+	inline constexpr std::uint32_t ultimate_mcts_expand_visits = 8;
+	inline constexpr int ultimate_think_milliseconds = 1500;
 } // namespace constants
 
-#endif
\ No newline at end of file
+#endif
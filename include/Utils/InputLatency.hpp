@@ -0,0 +1,47 @@
+#ifndef INPUT_LATENCY_HPP
+#define INPUT_LATENCY_HPP
+
+#include "Utils/LatencyHistogram.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct InputStamp
+{
+	std::uint64_t counter_;
+	std::uint64_t frame_;
+};
+
+// Follows input events from SDL_PollEvent through the Tick that consumes them to the
+// SDL_RenderPresent that first shows their effect.
+class InputLatency
+{
+private:
+	static constexpr std::size_t max_pending = 16;
+
+	LatencyHistogram poll_to_tick_us_;
+	LatencyHistogram poll_to_present_us_;
+	LatencyHistogram frames_to_present_;
+
+	std::array<InputStamp, max_pending> pending_;
+	std::size_t n_pending_;
+	std::uint64_t frame_;
+
+	static std::uint64_t ElapsedMicroseconds(std::uint64_t from, std::uint64_t to);
+
+public:
+	InputLatency();
+
+	InputStamp Stamp() const;
+
+	void Consumed(const InputStamp& stamp);
+
+	void Consumed(const InputStamp& stamp, std::uint64_t consumed_counter);
+
+	void Presented();
+
+	void Report();
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear histogram in the spirit of HdrHistogram: every power of two is split into
+// 2^sub_bucket_bits linear sub-buckets, giving ~3% relative precision over the full 64-bit range.
+class LatencyHistogram
+{
+private:
+	static constexpr std::size_t sub_bucket_bits = 5;
+	static constexpr std::size_t sub_bucket_count = std::size_t{ 1 } << sub_bucket_bits;
+	static constexpr std::size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+	std::array<std::uint64_t, bucket_count> counts_;
+	std::uint64_t total_count_;
+	std::uint64_t min_;
+	std::uint64_t max_;
+	long double sum_;
+
+	static std::size_t BucketIndex(std::uint64_t value);
+
+	static std::uint64_t BucketUpperBound(std::size_t index);
+
+public:
+	LatencyHistogram();
+
+	void Record(std::uint64_t value);
+
+	void Merge(const LatencyHistogram& other);
+
+	void Reset();
+
+	std::uint64_t Percentile(double percentile) const;
+
+	std::uint64_t Count() const;
+
+	std::uint64_t Min() const;
+
+	std::uint64_t Max() const;
+
+	double Mean() const;
+};
+
+#endif
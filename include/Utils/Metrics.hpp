@@ -0,0 +1,122 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include "Utils/LatencyHistogram.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Monotonic count; any thread may add to it.
+class MetricCounter
+{
+private:
+	std::atomic<std::uint64_t> value_;
+
+public:
+	MetricCounter();
+
+	void Add(std::uint64_t n = 1);
+
+	std::uint64_t Value() const;
+};
+
+// HDR histogram behind a mutex that only the exporter ever contends for. Quantiles cover the
+// values recorded since the previous collection; count and sum cover the whole run.
+class MetricHistogram
+{
+private:
+	std::mutex mutex_;
+	LatencyHistogram window_;
+	std::uint64_t count_;
+	long double sum_;
+
+public:
+	MetricHistogram();
+
+	void Record(std::uint64_t value);
+
+	// Copies the window out and clears it.
+	void Collect(LatencyHistogram* window, std::uint64_t* count, long double* sum);
+};
+
+// Process-wide registry rendered in the Prometheus text format by MetricsExporter. Everything
+// the game and the server record is registered when the registry is first used, so recording
+// never allocates and never takes a lock shared with other metrics.
+class Metrics
+{
+private:
+	enum class Type
+	{
+		COUNTER, GAUGE, SUMMARY
+	};
+
+	struct Family
+	{
+		std::string name_;
+		std::string help_;
+		Type type_;
+		std::size_t index_;
+	};
+
+	std::mutex registry_mutex_;
+	std::vector<Family> families_;
+	std::deque<MetricCounter> counters_;
+	std::deque<MetricHistogram> histograms_;
+	std::vector<std::function<double()>> gauges_;
+
+	// Reused between renders; only touched with registry_mutex_ held.
+	LatencyHistogram window_;
+
+	MetricHistogram* frame_time_us_;
+	MetricHistogram* tick_time_us_;
+	MetricHistogram* ai_move_us_;
+	MetricCounter* search_nodes_;
+	MetricCounter* table_probes_;
+	MetricCounter* table_hits_;
+	MetricCounter* mcts_playouts_;
+	MetricCounter* texture_uploads_;
+
+	Metrics();
+
+public:
+	static Metrics& Instance();
+
+	Metrics(const Metrics&) = delete;
+
+	Metrics& operator=(const Metrics&) = delete;
+
+	// Names follow Prometheus conventions (snake_case, unit suffix, _total for counters).
+	MetricCounter& AddCounter(const char* name, const char* help);
+
+	MetricHistogram& AddHistogram(const char* name, const char* help);
+
+	// value is called on the exporter thread.
+	void AddGauge(const char* name, const char* help, std::function<double()> value);
+
+	// Text exposition format 0.0.4; restarts every histogram window.
+	std::string Render();
+
+	MetricHistogram& FrameTime();
+
+	MetricHistogram& TickTime();
+
+	MetricHistogram& AiMoveLatency();
+
+	MetricCounter& SearchNodes();
+
+	MetricCounter& TableProbes();
+
+	MetricCounter& TableHits();
+
+	MetricCounter& MctsPlayouts();
+
+	MetricCounter& TextureUploads();
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+private:
+	static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+	std::array<T, Capacity> items_;
+	alignas(64) std::atomic<std::size_t> head_;
+	alignas(64) std::atomic<std::size_t> tail_;
+
+public:
+	SpscQueue() : items_(), head_(0), tail_(0)
+	{
+	}
+
+	bool Push(const T& item)
+	{
+		const std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+		if (tail - head_.load(std::memory_order_acquire) == Capacity)
+		{
+			return false;
+		}
+
+		items_[tail & (Capacity - 1)] = item;
+		tail_.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool Pop(T* item)
+	{
+		const std::size_t head = head_.load(std::memory_order_relaxed);
+
+		if (head == tail_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		*item = items_[head & (Capacity - 1)];
+		head_.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool Empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers pulling jobs from one queue. Jobs receive the index of the worker that
+// runs them, so callers can keep per-worker state (e.g. one Search per worker) without locks.
+class ThreadPool
+{
+private:
+	std::vector<std::thread> workers_;
+	std::deque<std::function<void(std::size_t)>> jobs_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	bool stopping_;
+
+	void WorkerLoop(std::size_t worker_index);
+
+public:
+	explicit ThreadPool(std::size_t n_workers = 0);
+
+	~ThreadPool();
+
+	void Submit(std::function<void(std::size_t)> job);
+
+	std::size_t Workers() const;
+};
+
+#endif
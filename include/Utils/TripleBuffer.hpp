@@ -0,0 +1,49 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-writer/single-reader hand-over of the latest value. The writer fills its back
+// slot and swaps it with the middle one, the reader swaps its front slot with the middle one only
+// when something new was published. Neither side ever waits and the reader skips stale values.
+template<typename T>
+class TripleBuffer
+{
+private:
+	static constexpr std::uint8_t index_mask = 0x3;
+	static constexpr std::uint8_t fresh_bit = 0x4;
+
+	std::array<T, 3> slots_;
+	std::atomic<std::uint8_t> middle_;
+	std::uint8_t back_;
+	std::uint8_t front_;
+
+public:
+	TripleBuffer() : slots_(), middle_(1), back_(0), front_(2)
+	{
+	}
+
+	T& Back()
+	{
+		return slots_[back_];
+	}
+
+	void Publish()
+	{
+		back_ = middle_.exchange(back_ | fresh_bit, std::memory_order_acq_rel) & index_mask;
+	}
+
+	const T& Front()
+	{
+		if (middle_.load(std::memory_order_relaxed) & fresh_bit)
+		{
+			front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+		}
+
+		return slots_[front_];
+	}
+};
+
+#endif
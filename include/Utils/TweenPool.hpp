@@ -0,0 +1,62 @@
+#ifndef TWEEN_POOL_HPP
+#define TWEEN_POOL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class Easing : std::uint8_t
+{
+	LINEAR, EASE_OUT_CUBIC, EASE_IN_OUT
+};
+
+using TweenHandle = std::uint32_t;
+
+inline constexpr TweenHandle invalid_tween = 0xFFFFFFFF;
+
+// Fixed-capacity tween storage laid out as struct-of-arrays. Starting and releasing tweens only
+// moves indices between a free list and a dense active list, and Update advances every running
+// tween in one pass, so no animation ever touches the heap. Time is measured in ticks.
+class TweenPool
+{
+private:
+	static constexpr std::size_t capacity = 4096;
+
+	std::array<float, capacity> from_;
+	std::array<float, capacity> to_;
+	std::array<std::int32_t, capacity> elapsed_ticks_;
+	std::array<std::int32_t, capacity> duration_ticks_;
+	std::array<Easing, capacity> easing_;
+	std::array<std::uint16_t, capacity> generation_;
+	std::array<std::uint16_t, capacity> active_position_;
+
+	std::array<std::uint16_t, capacity> free_;
+	std::size_t n_free_;
+	std::array<std::uint16_t, capacity> active_;
+	std::size_t n_active_;
+
+	bool Valid(TweenHandle handle) const;
+
+	void Deactivate(std::uint16_t index);
+
+	static float Ease(Easing easing, float t);
+
+public:
+	TweenPool();
+
+	TweenHandle Start(float from, float to, int duration_ticks, Easing easing = Easing::LINEAR, int delay_ticks = 0);
+
+	void Update();
+
+	float Value(TweenHandle handle, float alpha = 0.0f) const;
+
+	bool Finished(TweenHandle handle) const;
+
+	void Release(TweenHandle* handle);
+
+	void Clear();
+
+	std::size_t Active() const;
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "AI/Analysis.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/Constants.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+Analysis::Analysis() :
+	search_(1),
+	generation_(0),
+	has_position_(false),
+	stopping_(false)
+{
+	thread_ = std::thread(&Analysis::Loop, this);
+}
+
+Analysis::~Analysis()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+		search_.SetDeadline(std::chrono::steady_clock::now());
+	}
+
+	condition_.notify_one();
+	thread_.join();
+}
+
+std::uint64_t Analysis::SetPosition(const Position& position)
+{
+	std::uint64_t generation = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		position_ = position;
+		has_position_ = true;
+		generation = ++generation_;
+		search_.SetDeadline(std::chrono::steady_clock::now());
+	}
+
+	condition_.notify_one();
+
+	return generation;
+}
+
+void Analysis::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	has_position_ = false;
+	++generation_;
+	search_.SetDeadline(std::chrono::steady_clock::now());
+}
+
+const AnalysisResult& Analysis::Latest()
+{
+	return results_.Front();
+}
+
+bool Analysis::Current(std::uint64_t generation)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (stopping_ || !has_position_ || generation_ != generation)
+	{
+		return false;
+	}
+
+	// A replacement arriving after this point sets the deadline again, so the next search
+	// still notices it.
+	search_.ClearDeadline();
+
+	return true;
+}
+
+void Analysis::Loop()
+{
+	std::uint64_t seen_generation = 0;
+
+	while (true)
+	{
+		Position position;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this, seen_generation]() { return stopping_ || (has_position_ && generation_ != seen_generation); });
+
+			if (stopping_)
+			{
+				return;
+			}
+
+			seen_generation = generation_;
+			position = position_;
+		}
+
+		AnalysisResult result;
+		result.generation_ = seen_generation;
+		result.scores_.fill(0);
+		result.depths_.fill(0);
+
+		results_.Back() = result;
+		results_.Publish();
+
+		// Searching a child deeper than its free cells cannot change its value.
+		const int max_depth = std::clamp(static_cast<int>(position.FreeCells()) - 1, 1, constants::analysis_max_depth);
+		bool current = true;
+
+		for (int depth = 1; current && depth <= max_depth; ++depth)
+		{
+			for (std::size_t i = 0; i < position.Cells(); ++i)
+			{
+				if (position.At(i) != CellSymbol::EMPTY)
+				{
+					continue;
+				}
+
+				current = Current(seen_generation);
+
+				if (!current)
+				{
+					break;
+				}
+
+				Position child = position;
+				child.MakeMove(i);
+
+				int score = 0;
+
+				if (child.IsWinningMove(i))
+				{
+					score = Search::win_score - 1;
+				}
+				else if (child.FreeCells() != 0)
+				{
+					score = -search_.Run(child, depth).score_;
+
+					current = Current(seen_generation);
+
+					if (!current)
+					{
+						break;
+					}
+
+					// Mates found from the child are one ply further away from this position.
+					if (score > Search::win_threshold)
+					{
+						--score;
+					}
+					else if (score < -Search::win_threshold)
+					{
+						++score;
+					}
+				}
+
+				result.scores_[i] = score;
+				result.depths_[i] = static_cast<std::uint8_t>(depth);
+
+				results_.Back() = result;
+				results_.Publish();
+			}
+		}
+	}
+}
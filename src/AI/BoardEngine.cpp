@@ -0,0 +1,112 @@
+#include "AI/BoardEngine.hpp"
+#include "AI/Position.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+	constexpr int n_ternary_codes = 19683;
+
+	constexpr std::array<std::uint16_t, 9> powers_of_three = { 1, 3, 9, 27, 81, 243, 729, 2187, 6561 };
+
+	// Bit 0 set when X has a line, bit 1 when O has one: the CellSymbol values themselves, so a
+	// cell's symbol masks out its own bit.
+	constexpr std::array<std::uint8_t, n_ternary_codes> GenerateTernaryWinners()
+	{
+		std::array<std::uint16_t, 512> ternary = {};
+		std::array<std::uint8_t, 512> has_line = {};
+
+		for (int mask = 1; mask < 512; ++mask)
+		{
+			ternary[mask] = static_cast<std::uint16_t>((mask & 1) + 3 * ternary[mask >> 1]);
+		}
+
+		for (const board_engine::Line<3>& line : BoardEngine<3, 3>::lines)
+		{
+			const int line_mask = (1 << line[0]) | (1 << line[1]) | (1 << line[2]);
+
+			for (int mask = 0; mask < 512; ++mask)
+			{
+				has_line[mask] |= (mask & line_mask) == line_mask;
+			}
+		}
+
+		std::array<std::uint8_t, n_ternary_codes> winners = {};
+
+		// Every board is a pair of disjoint X and O masks; walk the O masks as subsets of the
+		// cells X leaves free.
+		for (int x_mask = 0; x_mask < 512; ++x_mask)
+		{
+			const int free_mask = ~x_mask & 511;
+			int o_mask = free_mask;
+
+			while (true)
+			{
+				winners[ternary[x_mask] + 2 * ternary[o_mask]] = static_cast<std::uint8_t>(has_line[x_mask] | (has_line[o_mask] << 1));
+
+				if (o_mask == 0)
+				{
+					break;
+				}
+
+				o_mask = (o_mask - 1) & free_mask;
+			}
+		}
+
+		return winners;
+	}
+
+	constexpr std::array<std::uint8_t, n_ternary_codes> ternary_winners = GenerateTernaryWinners();
+
+	constexpr std::array<CellSymbol, 4> winner_by_bits = { CellSymbol::EMPTY, CellSymbol::X, CellSymbol::O, CellSymbol::X };
+
+	std::uint8_t TernaryWinners(const CellSymbol* cells)
+	{
+		int code = 0;
+
+		for (std::size_t i = 0; i < powers_of_three.size(); ++i)
+		{
+			code += static_cast<int>(cells[i]) * powers_of_three[i];
+		}
+
+		return ternary_winners[code];
+	}
+} // namespace
+
+template <>
+bool BoardEngine<3, 3>::IsWinningMove(const CellSymbol* cells, std::size_t index)
+{
+	return (TernaryWinners(cells) & static_cast<int>(cells[index])) != 0;
+}
+
+template <>
+CellSymbol BoardEngine<3, 3>::Winner(const CellSymbol* cells)
+{
+	return winner_by_bits[TernaryWinners(cells)];
+}
+
+template class BoardEngine<3, 3>;
+template class BoardEngine<4, 4>;
+template class BoardEngine<15, 5>;
+
+const BoardEngineFunctions* SelectBoardEngine(std::size_t dimension, std::size_t n_symbols_to_win)
+{
+	if (dimension == 3 && n_symbols_to_win == 3)
+	{
+		return &BoardEngine<3, 3>::functions;
+	}
+
+	if (dimension == 4 && n_symbols_to_win == 4)
+	{
+		return &BoardEngine<4, 4>::functions;
+	}
+
+	if (dimension == 15 && n_symbols_to_win == 5)
+	{
+		return &BoardEngine<15, 5>::functions;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,159 @@
+#include "AI/Evaluator.hpp"
+#include "AI/Position.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	constexpr char weights_magic[4] = { 'E', 'V', 'W', '1' };
+} // namespace
+
+Evaluator::Evaluator() : weights_(DefaultWeights())
+{
+}
+
+Evaluator& Evaluator::Default()
+{
+	static Evaluator evaluator;
+	return evaluator;
+}
+
+evaluation::Weights Evaluator::DefaultWeights()
+{
+	// Hand-set starting point for the tuner: windows one stone from completion dominate, and
+	// the side to move converts its own threats before it has to answer the opponent's.
+	return { 
+		800.0f, 60.0f, 10.0f, 2.0f, 
+		-250.0f, -50.0f, -8.0f, -2.0f, 
+		10.0f 
+	};
+}
+
+void Evaluator::Features(const Position& position, evaluation::FeatureVector* features)
+{
+	features->fill(0);
+	(*features)[evaluation::TEMPO] = 1;
+
+	const int dimension = static_cast<int>(position.Dimension());
+	const int k = static_cast<int>(position.NSymbolsToWin());
+	const CellSymbol own = position.SideToMove();
+
+	constexpr int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+	for (const auto& direction : directions)
+	{
+		for (int row = 0; row < dimension; ++row)
+		{
+			const int end_row = row + direction[0] * (k - 1);
+
+			if (end_row < 0 || end_row >= dimension)
+			{
+				continue;
+			}
+
+			for (int col = 0; col < dimension; ++col)
+			{
+				const int end_col = col + direction[1] * (k - 1);
+
+				if (end_col < 0 || end_col >= dimension)
+				{
+					continue;
+				}
+
+				int n_own = 0;
+				int n_opponent = 0;
+
+				for (int i = 0; i < k && (n_own == 0 || n_opponent == 0); ++i)
+				{
+					const CellSymbol symbol = position.At((row + direction[0] * i) * dimension + col + direction[1] * i);
+
+					n_own += symbol == own;
+					n_opponent += symbol != own && symbol != CellSymbol::EMPTY;
+				}
+
+				if (n_own != 0 && n_opponent == 0 && n_own < k && k - n_own <= static_cast<int>(evaluation::max_missing))
+				{
+					++(*features)[evaluation::OWN_WINDOWS + k - n_own - 1];
+				}
+				else if (n_opponent != 0 && n_own == 0 && n_opponent < k && k - n_opponent <= static_cast<int>(evaluation::max_missing))
+				{
+					++(*features)[evaluation::OPPONENT_WINDOWS + k - n_opponent - 1];
+				}
+			}
+		}
+	}
+}
+
+int Evaluator::Evaluate(const Position& position) const
+{
+	evaluation::FeatureVector features;
+	Features(position, &features);
+
+	const int score = static_cast<int>(std::lround(Score(features)));
+
+	return std::clamp(score, -evaluation::max_score, evaluation::max_score);
+}
+
+float Evaluator::Score(const evaluation::FeatureVector& features) const
+{
+	float score = 0.0f;
+
+	for (std::size_t i = 0; i < evaluation::N_FEATURES; ++i)
+	{
+		score += weights_[i] * features[i];
+	}
+
+	return score;
+}
+
+const evaluation::Weights& Evaluator::GetWeights() const
+{
+	return weights_;
+}
+
+void Evaluator::SetWeights(const evaluation::Weights& weights)
+{
+	weights_ = weights;
+}
+
+bool Evaluator::LoadFromFile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	char magic[4];
+	std::uint32_t n_features = 0;
+
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, weights_magic, sizeof(magic)) != 0 || 
+		!file.read(reinterpret_cast<char*>(&n_features), sizeof(n_features)) || n_features != evaluation::N_FEATURES)
+	{
+		return false;
+	}
+
+	evaluation::Weights weights;
+
+	if (!file.read(reinterpret_cast<char*>(weights.data()), sizeof(weights)))
+	{
+		return false;
+	}
+
+	weights_ = weights;
+
+	return true;
+}
+
+bool Evaluator::SaveToFile(const char* path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	const std::uint32_t n_features = evaluation::N_FEATURES;
+
+	file.write(weights_magic, sizeof(weights_magic));
+	file.write(reinterpret_cast<const char*>(&n_features), sizeof(n_features));
+	file.write(reinterpret_cast<const char*>(weights_.data()), sizeof(weights_));
+
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,215 @@
+#include "AI/Network.hpp"
+#include "AI/Evaluator.hpp"
+#include "AI/Position.hpp"
+#include "Utils/Constants.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	constexpr char network_magic[4] = { 'N', 'N', 'U', '1' };
+
+	// Both pointers 32-byte aligned and n a multiple of 32.
+	std::int32_t Dot(const std::uint8_t* input, const std::int8_t* weights, std::size_t n)
+	{
+#if defined(__AVX2__)
+		const __m256i ones = _mm256_set1_epi16(1);
+		__m256i sum = _mm256_setzero_si256();
+
+		for (std::size_t i = 0; i < n; i += 32)
+		{
+			const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(input + i));
+			const __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+
+			// Inputs stay within [0, 127], so the pairwise int16 sums cannot saturate.
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+		}
+
+		__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		return _mm_cvtsi128_si32(half);
+#else
+		std::int32_t sum = 0;
+
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			sum += static_cast<std::int32_t>(input[i]) * weights[i];
+		}
+
+		return sum;
+#endif
+	}
+
+	void ClippedRelu(const std::int16_t* values, std::uint8_t* output)
+	{
+#if defined(__AVX2__)
+		const __m256i zero = _mm256_setzero_si256();
+
+		for (std::size_t i = 0; i < nnue::l1_size; i += 32)
+		{
+			const __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+			const __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i + 16));
+
+			// packs works per 128-bit lane; the permute restores the original order.
+			const __m256i packed = _mm256_max_epi8(_mm256_packs_epi16(low, high), zero);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(output + i), _mm256_permute4x64_epi64(packed, 0xD8));
+		}
+#else
+		for (std::size_t i = 0; i < nnue::l1_size; ++i)
+		{
+			output[i] = static_cast<std::uint8_t>(std::clamp<int>(values[i], 0, 127));
+		}
+#endif
+	}
+
+	template <typename T>
+	bool Read(std::ifstream& file, T* value)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(value), sizeof(T)));
+	}
+
+	template <typename T>
+	void Write(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+} // namespace
+
+Network::Network() :
+	feature_biases_(),
+	feature_weights_(),
+	hidden_biases_(),
+	hidden_weights_(),
+	output_weights_(),
+	output_bias_(0),
+	loaded_(false)
+{
+}
+
+Network& Network::Default()
+{
+	static Network network;
+	return network;
+}
+
+bool Network::Applies(const Position& position) const
+{
+	return loaded_ && position.Dimension() >= constants::nnue_min_board_dimension;
+}
+
+void Network::Refresh(const Position& position, nnue::Accumulator* accumulator) const
+{
+	for (std::size_t perspective = 0; perspective < 2; ++perspective)
+	{
+		std::array<std::int16_t, nnue::l1_size>& values = accumulator->values_[perspective];
+		values = feature_biases_;
+
+		for (std::size_t i = 0; i < position.Cells(); ++i)
+		{
+			if (position.At(i) == CellSymbol::EMPTY)
+			{
+				continue;
+			}
+
+			const std::array<std::int16_t, nnue::l1_size>& column = feature_weights_[FeatureIndex(perspective, position.At(i), i, position.Dimension())];
+
+			for (std::size_t j = 0; j < nnue::l1_size; ++j)
+			{
+				values[j] += column[j];
+			}
+		}
+	}
+}
+
+void Network::Update(const nnue::Accumulator& parent, nnue::Accumulator* child, const Position& position, std::size_t index) const
+{
+	for (std::size_t perspective = 0; perspective < 2; ++perspective)
+	{
+		const std::array<std::int16_t, nnue::l1_size>& column = feature_weights_[FeatureIndex(perspective, position.At(index), index, position.Dimension())];
+		const std::array<std::int16_t, nnue::l1_size>& from = parent.values_[perspective];
+		std::array<std::int16_t, nnue::l1_size>& to = child->values_[perspective];
+
+		for (std::size_t j = 0; j < nnue::l1_size; ++j)
+		{
+			to[j] = static_cast<std::int16_t>(from[j] + column[j]);
+		}
+	}
+}
+
+int Network::Evaluate(const nnue::Accumulator& accumulator, CellSymbol side_to_move) const
+{
+	const std::size_t own = side_to_move == CellSymbol::O;
+
+	alignas(32) std::array<std::uint8_t, 2 * nnue::l1_size> input;
+	ClippedRelu(accumulator.values_[own].data(), input.data());
+	ClippedRelu(accumulator.values_[1 - own].data(), input.data() + nnue::l1_size);
+
+	alignas(32) std::array<std::uint8_t, nnue::l2_size> hidden;
+
+	for (std::size_t i = 0; i < nnue::l2_size; ++i)
+	{
+		const std::int32_t sum = hidden_biases_[i] + Dot(input.data(), hidden_weights_[i].data(), input.size());
+		hidden[i] = static_cast<std::uint8_t>(std::clamp(sum >> nnue::hidden_shift, 0, 127));
+	}
+
+	const std::int32_t output = output_bias_ + Dot(hidden.data(), output_weights_.data(), hidden.size());
+
+	return std::clamp(output / nnue::output_divisor, -evaluation::max_score, evaluation::max_score);
+}
+
+bool Network::LoadFromFile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	char magic[4];
+	std::uint32_t n_inputs = 0;
+	std::uint32_t l1_size = 0;
+	std::uint32_t l2_size = 0;
+
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, network_magic, sizeof(magic)) != 0 ||
+		!Read(file, &n_inputs) || !Read(file, &l1_size) || !Read(file, &l2_size) ||
+		n_inputs != nnue::n_inputs || l1_size != nnue::l1_size || l2_size != nnue::l2_size)
+	{
+		return false;
+	}
+
+	loaded_ = Read(file, &feature_biases_) && Read(file, &feature_weights_) && Read(file, &hidden_biases_) &&
+		Read(file, &hidden_weights_) && Read(file, &output_bias_) && Read(file, &output_weights_);
+
+	return loaded_;
+}
+
+bool Network::SaveToFile(const char* path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+	file.write(network_magic, sizeof(network_magic));
+	Write(file, static_cast<std::uint32_t>(nnue::n_inputs));
+	Write(file, static_cast<std::uint32_t>(nnue::l1_size));
+	Write(file, static_cast<std::uint32_t>(nnue::l2_size));
+	Write(file, feature_biases_);
+	Write(file, feature_weights_);
+	Write(file, hidden_biases_);
+	Write(file, hidden_weights_);
+	Write(file, output_bias_);
+	Write(file, output_weights_);
+
+	return static_cast<bool>(file);
+}
+
+std::size_t Network::FeatureIndex(std::size_t perspective, CellSymbol symbol, std::size_t index, std::size_t dimension)
+{
+	const std::size_t cell = (index / dimension) * nnue::grid_dimension + index % dimension;
+	const bool own = (symbol == CellSymbol::O) == (perspective == 1);
+
+	return (own ? 0 : nnue::grid_dimension * nnue::grid_dimension) + cell;
+}
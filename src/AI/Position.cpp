@@ -0,0 +1,233 @@
+#include "AI/Position.hpp"
+#include "AI/BoardEngine.hpp"
+#include "Utils/Constants.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace
+{
+	struct ZobristKeys
+	{
+		std::array<std::array<std::uint64_t, 2>, constants::max_board_cells> cells_;
+		std::uint64_t side_;
+	};
+
+	constexpr std::uint64_t SplitMix64(std::uint64_t& state)
+	{
+		std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	constexpr ZobristKeys GenerateZobristKeys()
+	{
+		ZobristKeys keys = {};
+		std::uint64_t state = 0x54696354616354ULL;
+
+		for (std::size_t i = 0; i < constants::max_board_cells; ++i)
+		{
+			keys.cells_[i][0] = SplitMix64(state);
+			keys.cells_[i][1] = SplitMix64(state);
+		}
+
+		keys.side_ = SplitMix64(state);
+
+		return keys;
+	}
+
+	constexpr ZobristKeys zobrist_keys = GenerateZobristKeys();
+
+	std::uint64_t CellKey(std::size_t index, CellSymbol symbol)
+	{
+		return zobrist_keys.cells_[index][symbol == CellSymbol::O];
+	}
+
+	std::uint64_t VariantKey(std::size_t dimension, std::size_t n_symbols_to_win)
+	{
+		std::uint64_t state = (dimension << 8) | n_symbols_to_win;
+		return SplitMix64(state);
+	}
+} // namespace
+
+Position::Position() : Position(3, 3, CellSymbol::X)
+{
+}
+
+Position::Position(std::size_t dimension, std::size_t n_symbols_to_win, CellSymbol side_to_move)
+{
+	Reset(dimension, n_symbols_to_win, side_to_move);
+}
+
+void Position::Reset(std::size_t dimension, std::size_t n_symbols_to_win, CellSymbol side_to_move)
+{
+	assert(dimension <= constants::max_board_dimension);
+	assert(n_symbols_to_win <= dimension);
+	assert(side_to_move != CellSymbol::EMPTY);
+
+	cells_.fill(CellSymbol::EMPTY);
+	dimension_ = dimension;
+	n_symbols_to_win_ = n_symbols_to_win;
+	free_cells_ = dimension * dimension;
+	side_to_move_ = side_to_move;
+	hash_ = VariantKey(dimension, n_symbols_to_win) ^ (side_to_move == CellSymbol::O ? zobrist_keys.side_ : 0);
+	engine_ = SelectBoardEngine(dimension, n_symbols_to_win);
+}
+
+void Position::Set(std::size_t index, CellSymbol symbol)
+{
+	assert(index < Cells());
+
+	if (cells_[index] != CellSymbol::EMPTY)
+	{
+		hash_ ^= CellKey(index, cells_[index]);
+		++free_cells_;
+	}
+
+	cells_[index] = symbol;
+
+	if (symbol != CellSymbol::EMPTY)
+	{
+		hash_ ^= CellKey(index, symbol);
+		--free_cells_;
+	}
+}
+
+void Position::MakeMove(std::size_t index)
+{
+	assert(index < Cells() && cells_[index] == CellSymbol::EMPTY);
+
+	cells_[index] = side_to_move_;
+	hash_ ^= CellKey(index, side_to_move_) ^ zobrist_keys.side_;
+	--free_cells_;
+	side_to_move_ = Opponent(side_to_move_);
+}
+
+void Position::UnmakeMove(std::size_t index)
+{
+	assert(index < Cells() && cells_[index] == Opponent(side_to_move_));
+
+	side_to_move_ = Opponent(side_to_move_);
+	hash_ ^= CellKey(index, side_to_move_) ^ zobrist_keys.side_;
+	cells_[index] = CellSymbol::EMPTY;
+	++free_cells_;
+}
+
+bool Position::IsWinningMove(std::size_t index) const
+{
+	if (engine_ != nullptr)
+	{
+		return engine_->is_winning_move_(cells_.data(), index);
+	}
+
+	const CellSymbol symbol = cells_[index];
+
+	if (symbol == CellSymbol::EMPTY)
+	{
+		return false;
+	}
+
+	constexpr int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+	for (const auto& direction : directions)
+	{
+		const std::size_t line_length = 1 + CountInDirection(index, direction[0], direction[1], symbol) + CountInDirection(index, -direction[0], -direction[1], symbol);
+
+		if (line_length >= n_symbols_to_win_)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool Position::HasWinner(CellSymbol* winning_symbol) const
+{
+	if (engine_ != nullptr)
+	{
+		const CellSymbol winner = engine_->winner_(cells_.data());
+
+		if (winner != CellSymbol::EMPTY && winning_symbol != nullptr)
+		{
+			*winning_symbol = winner;
+		}
+
+		return winner != CellSymbol::EMPTY;
+	}
+
+	for (std::size_t i = 0; i < Cells(); ++i)
+	{
+		if (IsWinningMove(i))
+		{
+			if (winning_symbol != nullptr)
+			{
+				*winning_symbol = cells_[i];
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+CellSymbol Position::At(std::size_t index) const
+{
+	return cells_[index];
+}
+
+std::size_t Position::Cells() const
+{
+	return dimension_ * dimension_;
+}
+
+std::size_t Position::Dimension() const
+{
+	return dimension_;
+}
+
+std::size_t Position::NSymbolsToWin() const
+{
+	return n_symbols_to_win_;
+}
+
+std::size_t Position::FreeCells() const
+{
+	return free_cells_;
+}
+
+CellSymbol Position::SideToMove() const
+{
+	return side_to_move_;
+}
+
+std::uint64_t Position::Hash() const
+{
+	return hash_;
+}
+
+CellSymbol Position::Opponent(CellSymbol symbol)
+{
+	return symbol == CellSymbol::X ? CellSymbol::O : CellSymbol::X;
+}
+
+std::size_t Position::CountInDirection(std::size_t index, int row_step, int col_step, CellSymbol symbol) const
+{
+	const int board_dim = static_cast<int>(dimension_);
+
+	int row = static_cast<int>(index) / board_dim + row_step;
+	int col = static_cast<int>(index) % board_dim + col_step;
+	std::size_t count = 0;
+
+	while (row >= 0 && row < board_dim && col >= 0 && col < board_dim && cells_[row * board_dim + col] == symbol)
+	{
+		++count;
+		row += row_step;
+		col += col_step;
+	}
+
+	return count;
+}
@@ -0,0 +1,399 @@
+#include "AI/ProofNumberSearch.hpp"
+#include "AI/Position.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr char checkpoint_magic[4] = { 'P', 'N', 'S', '1' };
+
+	struct CheckpointHeader
+	{
+		char magic_[4];
+		std::uint32_t dimension_;
+		std::uint32_t n_symbols_to_win_;
+		std::uint32_t attacker_;
+		std::uint64_t root_hash_;
+		std::uint64_t entries_;
+		std::uint64_t nodes_;
+	};
+
+	std::uint32_t SaturatedAdd(std::uint32_t a, std::uint32_t b)
+	{
+		return std::min(a + b, ProofNumberSearch::infinity);
+	}
+
+	char SymbolChar(CellSymbol symbol)
+	{
+		return symbol == CellSymbol::X ? 'X' : 'O';
+	}
+} // namespace
+
+ProofNumberSearch::ProofNumberSearch(CellSymbol attacker, std::size_t memory_bytes) : 
+	attacker_(attacker), 
+	nodes_(0), 
+	next_checkpoint_(0), 
+	checkpoint_interval_(0)
+{
+	const std::size_t n_buckets = std::max<std::size_t>(1, memory_bytes / (sizeof(Entry) * bucket_size));
+	table_.resize(n_buckets * bucket_size, { 0, 0, 0, 0 });
+}
+
+void ProofNumberSearch::SetCheckpoint(const std::string& path, std::uint64_t interval)
+{
+	checkpoint_path_ = path;
+	checkpoint_interval_ = interval;
+	next_checkpoint_ = nodes_ + interval;
+}
+
+bool ProofNumberSearch::LoadCheckpoint(const Position& root)
+{
+	std::ifstream in(checkpoint_path_, std::ios::binary);
+
+	if (!in)
+	{
+		return false;
+	}
+
+	CheckpointHeader header;
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!in || !std::equal(std::begin(checkpoint_magic), std::end(checkpoint_magic), header.magic_) || 
+		header.dimension_ != root.Dimension() || header.n_symbols_to_win_ != root.NSymbolsToWin() || 
+		header.attacker_ != static_cast<std::uint32_t>(attacker_) || header.root_hash_ != root.Hash() || 
+		header.entries_ != table_.size())
+	{
+		printf("Checkpoint %s does not match this solve, starting from scratch\n", checkpoint_path_.c_str());
+		return false;
+	}
+
+	in.read(reinterpret_cast<char*>(table_.data()), table_.size() * sizeof(Entry));
+
+	if (!in)
+	{
+		printf("Checkpoint %s is truncated, starting from scratch\n", checkpoint_path_.c_str());
+		std::fill(table_.begin(), table_.end(), Entry{ 0, 0, 0, 0 });
+		return false;
+	}
+
+	root_ = root;
+	nodes_ = header.nodes_;
+	next_checkpoint_ = nodes_ + checkpoint_interval_;
+
+	return true;
+}
+
+bool ProofNumberSearch::SaveCheckpoint() const
+{
+	if (checkpoint_path_.empty())
+	{
+		return false;
+	}
+
+	const std::string tmp_path = checkpoint_path_ + ".tmp";
+	std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+
+	CheckpointHeader header = {};
+	std::copy(std::begin(checkpoint_magic), std::end(checkpoint_magic), header.magic_);
+	header.dimension_ = static_cast<std::uint32_t>(root_.Dimension());
+	header.n_symbols_to_win_ = static_cast<std::uint32_t>(root_.NSymbolsToWin());
+	header.attacker_ = static_cast<std::uint32_t>(attacker_);
+	header.root_hash_ = root_.Hash();
+	header.entries_ = table_.size();
+	header.nodes_ = nodes_;
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(table_.data()), table_.size() * sizeof(Entry));
+	out.close();
+
+	if (!out || std::rename(tmp_path.c_str(), checkpoint_path_.c_str()) != 0)
+	{
+		printf("Failed to write checkpoint %s!\n", checkpoint_path_.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool ProofNumberSearch::Solve(Position root)
+{
+	root_ = root;
+
+	CellSymbol winning_symbol = CellSymbol::EMPTY;
+
+	if (root.HasWinner(&winning_symbol))
+	{
+		return winning_symbol == attacker_;
+	}
+
+	if (root.FreeCells() == 0)
+	{
+		return false;
+	}
+
+	MultipleIterativeDeepening(root, infinity, infinity);
+	SaveCheckpoint();
+
+	std::uint32_t pn = 1;
+	std::uint32_t dn = 1;
+	Lookup(root.Hash(), &pn, &dn);
+
+	return pn == 0;
+}
+
+void ProofNumberSearch::WriteProofTree(Position root, std::ostream& out)
+{
+	std::uint32_t pn = 1;
+	std::uint32_t dn = 1;
+	Lookup(root.Hash(), &pn, &dn);
+
+	out << "# " << (pn == 0 ? "proof" : "disproof") << " tree, attacker " << SymbolChar(attacker_) << ", " 
+		<< root.Dimension() << "x" << root.Dimension() << " k=" << root.NSymbolsToWin() << "\n";
+
+	WriteTree(root, pn == 0, 0, out);
+}
+
+std::uint64_t ProofNumberSearch::Nodes() const
+{
+	return nodes_;
+}
+
+void ProofNumberSearch::MultipleIterativeDeepening(Position& position, std::uint32_t pn_threshold, std::uint32_t dn_threshold)
+{
+	const std::uint64_t work_start = nodes_++;
+	const bool or_node = position.SideToMove() == attacker_;
+
+	std::array<std::uint16_t, constants::max_board_cells> moves;
+	std::size_t n_moves = 0;
+
+	for (std::size_t i = 0; i < position.Cells(); ++i)
+	{
+		if (position.At(i) == CellSymbol::EMPTY)
+		{
+			moves[n_moves++] = static_cast<std::uint16_t>(i);
+		}
+	}
+
+	std::uint32_t pn = 0;
+	std::uint32_t dn = 0;
+
+	while (true)
+	{
+		std::uint32_t best = infinity;
+		std::uint32_t second_best = infinity;
+		std::uint32_t best_pn = 0;
+		std::uint32_t best_dn = 0;
+		std::size_t best_move = moves[0];
+
+		pn = or_node ? infinity : 0;
+		dn = or_node ? 0 : infinity;
+
+		for (std::size_t i = 0; i < n_moves; ++i)
+		{
+			std::uint32_t child_pn = 0;
+			std::uint32_t child_dn = 0;
+			ChildNumbers(position, moves[i], &child_pn, &child_dn);
+
+			if (or_node)
+			{
+				pn = std::min(pn, child_pn);
+				dn = SaturatedAdd(dn, child_dn);
+			}
+			else
+			{
+				pn = SaturatedAdd(pn, child_pn);
+				dn = std::min(dn, child_dn);
+			}
+
+			const std::uint32_t selector = or_node ? child_pn : child_dn;
+
+			if (selector < best)
+			{
+				second_best = best;
+				best = selector;
+				best_pn = child_pn;
+				best_dn = child_dn;
+				best_move = moves[i];
+			}
+			else if (selector < second_best)
+			{
+				second_best = selector;
+			}
+		}
+
+		if (pn >= pn_threshold || dn >= dn_threshold || pn == 0 || dn == 0)
+		{
+			break;
+		}
+
+		std::uint32_t child_pn_threshold = 0;
+		std::uint32_t child_dn_threshold = 0;
+
+		if (or_node)
+		{
+			child_pn_threshold = std::min(pn_threshold, SaturatedAdd(second_best, 1));
+			child_dn_threshold = std::min(infinity, dn_threshold - dn + best_dn);
+		}
+		else
+		{
+			child_dn_threshold = std::min(dn_threshold, SaturatedAdd(second_best, 1));
+			child_pn_threshold = std::min(infinity, pn_threshold - pn + best_pn);
+		}
+
+		position.MakeMove(best_move);
+		MultipleIterativeDeepening(position, child_pn_threshold, child_dn_threshold);
+		position.UnmakeMove(best_move);
+
+		if (checkpoint_interval_ != 0 && nodes_ >= next_checkpoint_)
+		{
+			SaveCheckpoint();
+			next_checkpoint_ = nodes_ + checkpoint_interval_;
+		}
+	}
+
+	StoreEntry(position.Hash(), pn, dn, nodes_ - work_start);
+}
+
+bool ProofNumberSearch::ChildNumbers(Position& position, std::size_t index, std::uint32_t* pn, std::uint32_t* dn)
+{
+	position.MakeMove(index);
+
+	bool terminal = true;
+
+	if (position.IsWinningMove(index))
+	{
+		const bool attacker_won = position.At(index) == attacker_;
+		*pn = attacker_won ? 0 : infinity;
+		*dn = attacker_won ? infinity : 0;
+	}
+	else if (position.FreeCells() == 0)
+	{
+		*pn = infinity;
+		*dn = 0;
+	}
+	else
+	{
+		terminal = false;
+
+		if (!Lookup(position.Hash(), pn, dn))
+		{
+			*pn = 1;
+			*dn = 1;
+		}
+	}
+
+	position.UnmakeMove(index);
+
+	return terminal;
+}
+
+void ProofNumberSearch::SolvedChildNumbers(Position& position, std::size_t index, std::uint32_t* pn, std::uint32_t* dn)
+{
+	if (ChildNumbers(position, index, pn, dn) || *pn == 0 || *dn == 0)
+	{
+		return;
+	}
+
+	// The entry was evicted or never finished; solve this subtree again before descending.
+	position.MakeMove(index);
+	MultipleIterativeDeepening(position, infinity, infinity);
+	position.UnmakeMove(index);
+
+	ChildNumbers(position, index, pn, dn);
+}
+
+bool ProofNumberSearch::Lookup(std::uint64_t key, std::uint32_t* pn, std::uint32_t* dn) const
+{
+	const std::size_t bucket = (key % (table_.size() / bucket_size)) * bucket_size;
+
+	for (std::size_t i = bucket; i < bucket + bucket_size; ++i)
+	{
+		if (table_[i].key_ == key && table_[i].work_ != 0)
+		{
+			*pn = table_[i].pn_;
+			*dn = table_[i].dn_;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ProofNumberSearch::StoreEntry(std::uint64_t key, std::uint32_t pn, std::uint32_t dn, std::uint64_t work)
+{
+	const std::size_t bucket = (key % (table_.size() / bucket_size)) * bucket_size;
+	std::size_t victim = bucket;
+
+	for (std::size_t i = bucket; i < bucket + bucket_size; ++i)
+	{
+		if (table_[i].key_ == key)
+		{
+			victim = i;
+			work += table_[i].work_;
+			break;
+		}
+
+		if (table_[i].work_ < table_[victim].work_)
+		{
+			victim = i;
+		}
+	}
+
+	table_[victim] = { key, pn, dn, std::max<std::uint64_t>(work, 1) };
+}
+
+void ProofNumberSearch::WriteTree(Position& position, bool proof, std::size_t ply, std::ostream& out)
+{
+	const bool or_node = position.SideToMove() == attacker_;
+	const bool choose_one = proof == or_node;
+
+	for (std::size_t i = 0; i < position.Cells(); ++i)
+	{
+		if (position.At(i) != CellSymbol::EMPTY)
+		{
+			continue;
+		}
+
+		std::uint32_t pn = 0;
+		std::uint32_t dn = 0;
+		SolvedChildNumbers(position, i, &pn, &dn);
+
+		if ((proof ? pn : dn) != 0)
+		{
+			continue;
+		}
+
+		out << std::string(ply * 2, ' ') << SymbolChar(position.SideToMove()) 
+			<< " (" << i / position.Dimension() << "," << i % position.Dimension() << ")";
+
+		position.MakeMove(i);
+
+		if (position.IsWinningMove(i))
+		{
+			out << " wins\n";
+		}
+		else if (position.FreeCells() == 0)
+		{
+			out << " draw\n";
+		}
+		else
+		{
+			out << "\n";
+			WriteTree(position, proof, ply + 1, out);
+		}
+
+		position.UnmakeMove(i);
+
+		if (choose_one)
+		{
+			return;
+		}
+	}
+}
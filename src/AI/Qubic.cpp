@@ -0,0 +1,518 @@
+#include "AI/Qubic.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "AI/TranspositionTable.hpp"
+#include "Utils/AllocationTracker.hpp"
+#include "Utils/Metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+	constexpr std::uint64_t SplitMix64(std::uint64_t& state)
+	{
+		std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	struct ZobristKeys
+	{
+		std::array<std::array<std::uint64_t, 2>, qubic::n_cells> cells_;
+		std::uint64_t side_;
+	};
+
+	constexpr ZobristKeys GenerateZobristKeys()
+	{
+		ZobristKeys keys = {};
+		std::uint64_t state = 0x5175626963ULL;
+
+		for (int i = 0; i < qubic::n_cells; ++i)
+		{
+			keys.cells_[i][0] = SplitMix64(state);
+			keys.cells_[i][1] = SplitMix64(state);
+		}
+
+		keys.side_ = SplitMix64(state);
+
+		return keys;
+	}
+
+	constexpr ZobristKeys zobrist_keys = GenerateZobristKeys();
+
+	// Value of a line only one side has stones on, by the number of stones.
+	constexpr std::array<int, qubic::side + 1> line_weights = { 0, 1, 6, 40, 0 };
+
+	int PopCount(std::uint64_t bits)
+	{
+		return __builtin_popcountll(bits);
+	}
+
+	int LowestCell(std::uint64_t bits)
+	{
+		return __builtin_ctzll(bits);
+	}
+
+	int ScoreToTable(int score, int ply)
+	{
+		if (score > QubicSearch::win_threshold)
+		{
+			return score + ply;
+		}
+
+		if (score < -QubicSearch::win_threshold)
+		{
+			return score - ply;
+		}
+
+		return score;
+	}
+
+	int ScoreFromTable(int score, int ply)
+	{
+		if (score > QubicSearch::win_threshold)
+		{
+			return score - ply;
+		}
+
+		if (score < -QubicSearch::win_threshold)
+		{
+			return score + ply;
+		}
+
+		return score;
+	}
+} // namespace
+
+std::uint64_t qubic::WinningCells(std::uint64_t own, std::uint64_t other)
+{
+	std::uint64_t cells = 0;
+
+	for (const std::uint64_t line : lines)
+	{
+		if ((line & other) == 0 && PopCount(line & own) == side - 1)
+		{
+			cells |= line & ~own;
+		}
+	}
+
+	return cells;
+}
+
+QubicPosition::QubicPosition()
+{
+	Reset(CellSymbol::X);
+}
+
+void QubicPosition::Reset(CellSymbol side_to_move)
+{
+	assert(side_to_move != CellSymbol::EMPTY);
+
+	stones_ = { 0, 0 };
+	side_to_move_ = side_to_move;
+	hash_ = side_to_move == CellSymbol::O ? zobrist_keys.side_ : 0;
+}
+
+void QubicPosition::MakeMove(std::size_t index)
+{
+	assert(At(index) == CellSymbol::EMPTY);
+
+	const std::size_t side = side_to_move_ == CellSymbol::O;
+
+	stones_[side] |= std::uint64_t{ 1 } << index;
+	hash_ ^= zobrist_keys.cells_[index][side] ^ zobrist_keys.side_;
+	side_to_move_ = Position::Opponent(side_to_move_);
+}
+
+void QubicPosition::UnmakeMove(std::size_t index)
+{
+	side_to_move_ = Position::Opponent(side_to_move_);
+
+	const std::size_t side = side_to_move_ == CellSymbol::O;
+
+	assert((stones_[side] >> index) & 1);
+
+	stones_[side] &= ~(std::uint64_t{ 1 } << index);
+	hash_ ^= zobrist_keys.cells_[index][side] ^ zobrist_keys.side_;
+}
+
+bool QubicPosition::IsWinningMove(std::size_t index) const
+{
+	return WinningLines(index) != 0;
+}
+
+std::uint64_t QubicPosition::WinningLines(std::size_t index) const
+{
+	const CellSymbol symbol = At(index);
+
+	if (symbol == CellSymbol::EMPTY)
+	{
+		return 0;
+	}
+
+	const std::uint64_t own = Stones(symbol);
+	const qubic::CellLines& lines = qubic::cell_lines[index];
+	std::uint64_t winning_lines = 0;
+
+	for (std::size_t i = 0; i < lines.size_; ++i)
+	{
+		const std::uint64_t line = qubic::lines[lines.lines_[i]];
+
+		if ((own & line) == line)
+		{
+			winning_lines |= line;
+		}
+	}
+
+	return winning_lines;
+}
+
+CellSymbol QubicPosition::At(std::size_t index) const
+{
+	assert(index < static_cast<std::size_t>(qubic::n_cells));
+
+	if ((stones_[0] >> index) & 1)
+	{
+		return CellSymbol::X;
+	}
+
+	if ((stones_[1] >> index) & 1)
+	{
+		return CellSymbol::O;
+	}
+
+	return CellSymbol::EMPTY;
+}
+
+std::uint64_t QubicPosition::Stones(CellSymbol symbol) const
+{
+	return stones_[symbol == CellSymbol::O];
+}
+
+std::uint64_t QubicPosition::EmptyCells() const
+{
+	return ~(stones_[0] | stones_[1]);
+}
+
+std::size_t QubicPosition::FreeCells() const
+{
+	return static_cast<std::size_t>(PopCount(EmptyCells()));
+}
+
+CellSymbol QubicPosition::SideToMove() const
+{
+	return side_to_move_;
+}
+
+std::uint64_t QubicPosition::Hash() const
+{
+	return hash_;
+}
+
+QubicSearch::QubicSearch(std::size_t n_table_entries) :
+	transposition_table_(n_table_entries),
+	history_({}),
+	stop_(false),
+	deadline_(0),
+	table_probes_(0),
+	table_hits_(0)
+{
+}
+
+SearchResult QubicSearch::Run(const QubicPosition& position, int max_depth)
+{
+	const AllocationScope allocations;
+
+	SearchResult result = { -1, 0, 0, 0 };
+
+	stop_ = false;
+	table_probes_ = 0;
+	table_hits_ = 0;
+
+	// Old history still says something about the position, but should not drown out this search.
+	for (int& value : history_)
+	{
+		value /= 2;
+	}
+
+	if (position.EmptyCells() == 0)
+	{
+		return result;
+	}
+
+	QubicPosition search_position = position;
+
+	for (int depth = 1; depth <= max_depth; ++depth)
+	{
+		int best_move = -1;
+		const int score = Negamax(search_position, depth, 0, -win_score, win_score, &best_move, &result.nodes_);
+
+		if (stop_.load(std::memory_order_relaxed))
+		{
+			break;
+		}
+
+		result.best_move_ = best_move;
+		result.score_ = score;
+		result.depth_ = depth;
+
+		if (score > win_threshold || score < -win_threshold)
+		{
+			break;
+		}
+	}
+
+	if (result.best_move_ == -1)
+	{
+		result.best_move_ = LowestCell(position.EmptyCells());
+	}
+
+	Metrics& metrics = Metrics::Instance();
+	metrics.SearchNodes().Add(result.nodes_);
+	metrics.TableProbes().Add(table_probes_);
+	metrics.TableHits().Add(table_hits_);
+
+	AllocationTracker::ExpectNone("qubic search", allocations.Stats());
+
+	return result;
+}
+
+void QubicSearch::Stop()
+{
+	stop_ = true;
+}
+
+void QubicSearch::SetDeadline(std::chrono::steady_clock::time_point deadline)
+{
+	deadline_ = std::max<std::int64_t>(1, deadline.time_since_epoch().count());
+}
+
+void QubicSearch::ClearDeadline()
+{
+	deadline_ = 0;
+}
+
+void QubicSearch::Clear()
+{
+	transposition_table_.Clear();
+	history_.fill(0);
+}
+
+int QubicSearch::Negamax(QubicPosition& position, int depth, int ply, int alpha, int beta, int* best_move, std::uint64_t* nodes)
+{
+	++*nodes;
+
+	if ((*nodes & 1023) == 0)
+	{
+		const std::int64_t deadline = deadline_.load(std::memory_order_relaxed);
+
+		if (deadline != 0 && std::chrono::steady_clock::now().time_since_epoch().count() >= deadline)
+		{
+			stop_ = true;
+		}
+	}
+
+	const std::uint64_t empty = position.EmptyCells();
+
+	if (empty == 0)
+	{
+		return 0;
+	}
+
+	const CellSymbol side = position.SideToMove();
+	const std::uint64_t own = position.Stones(side);
+	const std::uint64_t other = position.Stones(Position::Opponent(side));
+
+	const std::uint64_t wins = qubic::WinningCells(own, other);
+
+	if (wins != 0)
+	{
+		if (best_move != nullptr)
+		{
+			*best_move = LowestCell(wins);
+		}
+
+		return win_score - (ply + 1);
+	}
+
+	const std::uint64_t threats = qubic::WinningCells(other, own);
+
+	if (threats != 0)
+	{
+		const int block = LowestCell(threats);
+
+		if (best_move != nullptr)
+		{
+			*best_move = block;
+		}
+
+		if (PopCount(threats) > 1)
+		{
+			return -(win_score - (ply + 2));
+		}
+
+		position.MakeMove(block);
+		const int score = -Negamax(position, depth, ply + 1, -beta, -alpha, nullptr, nodes);
+		position.UnmakeMove(block);
+
+		return score;
+	}
+
+	if (depth == 0)
+	{
+		return Evaluate(position);
+	}
+
+	const std::uint64_t key = position.Hash();
+	const int alpha_orig = alpha;
+
+	TranspositionEntry entry;
+	int table_move = -1;
+
+	++table_probes_;
+
+	if (transposition_table_.Probe(key, &entry))
+	{
+		++table_hits_;
+		table_move = entry.best_move_;
+
+		if (ply > 0 && entry.depth_ >= depth)
+		{
+			const int table_score = ScoreFromTable(entry.score_, ply);
+
+			if (entry.bound_ == Bound::EXACT ||
+				(entry.bound_ == Bound::LOWER && table_score >= beta) ||
+				(entry.bound_ == Bound::UPPER && table_score <= alpha))
+			{
+				return table_score;
+			}
+		}
+	}
+
+	// Cells are ordered by how much the lines through them are worth to either side, with the
+	// history of earlier cutoffs breaking ties.
+	std::array<int, qubic::n_lines> line_values;
+
+	for (int i = 0; i < qubic::n_lines; ++i)
+	{
+		const int n_own = PopCount(qubic::lines[i] & own);
+		const int n_other = PopCount(qubic::lines[i] & other);
+
+		line_values[i] = (n_other == 0 ? line_weights[n_own] + 1 : 0) + (n_own == 0 ? line_weights[n_other] : 0);
+	}
+
+	std::array<int, qubic::n_cells> moves;
+	std::array<int, qubic::n_cells> move_keys;
+	int n_moves = 0;
+
+	for (std::uint64_t remaining = empty; remaining != 0; remaining &= remaining - 1)
+	{
+		const int cell = LowestCell(remaining);
+		const qubic::CellLines& lines = qubic::cell_lines[cell];
+		int line_value = 0;
+
+		for (std::size_t i = 0; i < lines.size_; ++i)
+		{
+			line_value += line_values[lines.lines_[i]];
+		}
+
+		int move_key = cell == table_move ? std::numeric_limits<int>::max() : line_value * 65536 + std::min(history_[cell], 65535);
+		int n = n_moves++;
+
+		for (; n > 0 && move_keys[n - 1] < move_key; --n)
+		{
+			moves[n] = moves[n - 1];
+			move_keys[n] = move_keys[n - 1];
+		}
+
+		moves[n] = cell;
+		move_keys[n] = move_key;
+	}
+
+	int best_score = -win_score;
+	int local_best_move = moves[0];
+
+	for (int n = 0; n < n_moves; ++n)
+	{
+		const int index = moves[n];
+
+		position.MakeMove(index);
+		const int score = -Negamax(position, depth - 1, ply + 1, -beta, -alpha, nullptr, nodes);
+		position.UnmakeMove(index);
+
+		if (stop_.load(std::memory_order_relaxed))
+		{
+			return 0;
+		}
+
+		if (score > best_score)
+		{
+			best_score = score;
+			local_best_move = index;
+
+			if (score > alpha)
+			{
+				alpha = score;
+
+				if (alpha >= beta)
+				{
+					history_[index] += depth * depth;
+					break;
+				}
+			}
+		}
+	}
+
+	Bound bound = Bound::EXACT;
+
+	if (best_score <= alpha_orig)
+	{
+		bound = Bound::UPPER;
+	}
+	else if (best_score >= beta)
+	{
+		bound = Bound::LOWER;
+	}
+
+	transposition_table_.Store(key, { ScoreToTable(best_score, ply), local_best_move, depth, bound });
+
+	if (best_move != nullptr)
+	{
+		*best_move = local_best_move;
+	}
+
+	return best_score;
+}
+
+int QubicSearch::Evaluate(const QubicPosition& position) const
+{
+	const CellSymbol side = position.SideToMove();
+	const std::uint64_t own = position.Stones(side);
+	const std::uint64_t other = position.Stones(Position::Opponent(side));
+
+	int score = 0;
+
+	for (const std::uint64_t line : qubic::lines)
+	{
+		const int n_own = PopCount(line & own);
+		const int n_other = PopCount(line & other);
+
+		if (n_other == 0)
+		{
+			score += line_weights[n_own];
+		}
+		else if (n_own == 0)
+		{
+			score -= line_weights[n_other];
+		}
+	}
+
+	return score;
+}
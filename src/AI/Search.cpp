@@ -0,0 +1,464 @@
+#include "AI/Search.hpp"
+#include "AI/Evaluator.hpp"
+#include "AI/Network.hpp"
+#include "AI/Position.hpp"
+#include "AI/TranspositionTable.hpp"
+#include "Utils/AllocationTracker.hpp"
+#include "Utils/Metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	int ScoreToTable(int score, int ply)
+	{
+		if (score > Search::win_threshold)
+		{
+			return score + ply;
+		}
+
+		if (score < -Search::win_threshold)
+		{
+			return score - ply;
+		}
+
+		return score;
+	}
+
+	int ScoreFromTable(int score, int ply)
+	{
+		if (score > Search::win_threshold)
+		{
+			return score - ply;
+		}
+
+		if (score < -Search::win_threshold)
+		{
+			return score + ply;
+		}
+
+		return score;
+	}
+} // namespace
+
+Search::Search(std::size_t n_threads, std::size_t n_table_entries) : 
+	transposition_table_(n_table_entries), 
+	evaluator_(&Evaluator::Default()),
+	network_(&Network::Default()),
+	network_active_(false),
+	n_threads_(n_threads), 
+	stop_(false), 
+	helpers_stop_(false), 
+	deadline_(0), 
+	helper_nodes_(0),
+	generation_(0),
+	helpers_running_(0),
+	shutting_down_(false),
+	run_position_(nullptr),
+	run_max_depth_(0),
+	helper_allocations_(0),
+	helper_allocated_bytes_(0),
+	last_run_allocations_({ 0, 0 })
+{
+	if (n_threads_ == 0)
+	{
+		n_threads_ = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	accumulators_.resize(n_threads_ * (constants::max_board_cells + 1));
+	table_counters_.resize(n_threads_);
+	helpers_.reserve(n_threads_ - 1);
+
+	for (std::size_t i = 1; i < n_threads_; ++i)
+	{
+		helpers_.emplace_back(&Search::HelperLoop, this, i);
+	}
+}
+
+Search::~Search()
+{
+	{
+		std::lock_guard<std::mutex> lock(run_mutex_);
+		shutting_down_ = true;
+	}
+
+	run_condition_.notify_all();
+
+	for (std::thread& helper : helpers_)
+	{
+		helper.join();
+	}
+}
+
+SearchResult Search::Run(const Position& position, int max_depth)
+{
+	const AllocationScope allocations;
+
+	stop_ = false;
+	helpers_stop_ = false;
+	helper_nodes_ = 0;
+	helper_allocations_ = 0;
+	helper_allocated_bytes_ = 0;
+	table_counters_.assign(n_threads_, { 0, 0 });
+	network_active_ = network_ != nullptr && network_->Applies(position);
+
+	if (!helpers_.empty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(run_mutex_);
+			run_position_ = &position;
+			run_max_depth_ = max_depth;
+			helpers_running_ = helpers_.size();
+			++generation_;
+		}
+
+		run_condition_.notify_all();
+	}
+
+	SearchResult result = IterativeDeepening(position, max_depth, 0);
+
+	helpers_stop_ = true;
+
+	if (!helpers_.empty())
+	{
+		std::unique_lock<std::mutex> lock(run_mutex_);
+		done_condition_.wait(lock, [this]() { return helpers_running_ == 0; });
+	}
+
+	result.nodes_ += helper_nodes_;
+
+	TableCounters table_totals = { 0, 0 };
+
+	for (const TableCounters& counters : table_counters_)
+	{
+		table_totals.probes_ += counters.probes_;
+		table_totals.hits_ += counters.hits_;
+	}
+
+	Metrics& metrics = Metrics::Instance();
+	metrics.SearchNodes().Add(result.nodes_);
+	metrics.TableProbes().Add(table_totals.probes_);
+	metrics.TableHits().Add(table_totals.hits_);
+
+	const AllocationStats main_allocations = allocations.Stats();
+	last_run_allocations_ = { main_allocations.allocations_ + helper_allocations_, main_allocations.bytes_ + helper_allocated_bytes_ };
+	AllocationTracker::ExpectNone("search", last_run_allocations_);
+
+	return result;
+}
+
+void Search::HelperLoop(std::size_t thread_index)
+{
+	std::uint64_t seen_generation = 0;
+
+	while (true)
+	{
+		Position position;
+		int max_depth = 0;
+
+		{
+			std::unique_lock<std::mutex> lock(run_mutex_);
+			run_condition_.wait(lock, [this, seen_generation]() { return shutting_down_ || generation_ != seen_generation; });
+
+			if (shutting_down_)
+			{
+				return;
+			}
+
+			seen_generation = generation_;
+			position = *run_position_;
+			max_depth = run_max_depth_;
+		}
+
+		const AllocationScope allocations;
+
+		IterativeDeepening(position, max_depth, thread_index);
+
+		const AllocationStats stats = allocations.Stats();
+		helper_allocations_ += stats.allocations_;
+		helper_allocated_bytes_ += stats.bytes_;
+
+		std::lock_guard<std::mutex> lock(run_mutex_);
+
+		if (--helpers_running_ == 0)
+		{
+			done_condition_.notify_one();
+		}
+	}
+}
+
+void Search::Stop()
+{
+	stop_ = true;
+}
+
+void Search::SetDeadline(std::chrono::steady_clock::time_point deadline)
+{
+	deadline_ = std::max<std::int64_t>(1, deadline.time_since_epoch().count());
+}
+
+void Search::ClearDeadline()
+{
+	deadline_ = 0;
+}
+
+void Search::SetEvaluator(const Evaluator* evaluator)
+{
+	evaluator_ = evaluator;
+}
+
+void Search::SetNetwork(const Network* network)
+{
+	network_ = network;
+}
+
+void Search::SetIterationCallback(std::function<void(const SearchResult&)> callback)
+{
+	iteration_callback_ = std::move(callback);
+}
+
+int Search::TableMove(const Position& position) const
+{
+	TranspositionEntry entry;
+
+	if (transposition_table_.Probe(position.Hash(), &entry) && entry.best_move_ >= 0 && 
+		static_cast<std::size_t>(entry.best_move_) < position.Cells() && position.At(entry.best_move_) == CellSymbol::EMPTY)
+	{
+		return entry.best_move_;
+	}
+
+	return -1;
+}
+
+void Search::Clear()
+{
+	transposition_table_.Clear();
+}
+
+std::size_t Search::Threads() const
+{
+	return n_threads_;
+}
+
+AllocationStats Search::LastRunAllocations() const
+{
+	return last_run_allocations_;
+}
+
+SearchResult Search::IterativeDeepening(Position position, int max_depth, std::size_t thread_index)
+{
+	SearchResult result = { -1, 0, 0, 0 };
+
+	if (position.FreeCells() == 0)
+	{
+		return result;
+	}
+
+	nnue::Accumulator* accumulator = nullptr;
+
+	if (network_active_)
+	{
+		accumulator = &accumulators_[thread_index * (constants::max_board_cells + 1)];
+		network_->Refresh(position, accumulator);
+	}
+
+	const int start_depth = 1 + static_cast<int>(thread_index & 1);
+
+	for (int depth = start_depth; depth <= max_depth; ++depth)
+	{
+		int best_move = -1;
+		const std::uint64_t nodes_before = result.nodes_;
+		const int score = Negamax(position, accumulator, depth, 0, -win_score, win_score, thread_index, &best_move, &result.nodes_);
+
+		if (thread_index != 0)
+		{
+			helper_nodes_ += result.nodes_ - nodes_before;
+		}
+
+		if (Stopped(thread_index))
+		{
+			break;
+		}
+
+		result.best_move_ = best_move;
+		result.score_ = score;
+		result.depth_ = depth;
+
+		if (thread_index == 0 && iteration_callback_)
+		{
+			iteration_callback_({ result.best_move_, result.score_, result.depth_, result.nodes_ + helper_nodes_ });
+		}
+
+		if (score > win_threshold || score < -win_threshold)
+		{
+			break;
+		}
+	}
+
+	for (std::size_t i = 0; result.best_move_ == -1 && i < position.Cells(); ++i)
+	{
+		if (position.At(i) == CellSymbol::EMPTY)
+		{
+			result.best_move_ = static_cast<int>(i);
+		}
+	}
+
+	return result;
+}
+
+int Search::Negamax(Position& position, nnue::Accumulator* accumulator, int depth, int ply, int alpha, int beta, std::size_t thread_index, int* best_move, std::uint64_t* nodes)
+{
+	++*nodes;
+
+	if (thread_index == 0 && (*nodes & 1023) == 0)
+	{
+		const std::int64_t deadline = deadline_.load(std::memory_order_relaxed);
+
+		if (deadline != 0 && std::chrono::steady_clock::now().time_since_epoch().count() >= deadline)
+		{
+			stop_ = true;
+		}
+	}
+
+	if (position.FreeCells() == 0)
+	{
+		return 0;
+	}
+
+	if (depth == 0)
+	{
+		return accumulator != nullptr ? network_->Evaluate(*accumulator, position.SideToMove()) : evaluator_->Evaluate(position);
+	}
+
+	const std::uint64_t key = position.Hash();
+	const int alpha_orig = alpha;
+
+	TranspositionEntry entry;
+	int table_move = -1;
+
+	TableCounters& table_counters = table_counters_[thread_index];
+	++table_counters.probes_;
+
+	if (transposition_table_.Probe(key, &entry))
+	{
+		++table_counters.hits_;
+		table_move = entry.best_move_;
+
+		if (ply > 0 && entry.depth_ >= depth)
+		{
+			const int table_score = ScoreFromTable(entry.score_, ply);
+
+			if (entry.bound_ == Bound::EXACT || 
+				(entry.bound_ == Bound::LOWER && table_score >= beta) || 
+				(entry.bound_ == Bound::UPPER && table_score <= alpha))
+			{
+				return table_score;
+			}
+		}
+	}
+
+	const std::size_t n_cells = position.Cells();
+	const std::size_t rotation = (thread_index * 7) % n_cells;
+
+	int best_score = -win_score;
+	int local_best_move = -1;
+
+	for (std::size_t n = 0; n <= n_cells; ++n)
+	{
+		int index = -1;
+
+		if (n == 0)
+		{
+			index = table_move;
+		}
+		else
+		{
+			index = static_cast<int>((n - 1 + rotation) % n_cells);
+
+			if (index == table_move)
+			{
+				continue;
+			}
+		}
+
+		if (index < 0 || static_cast<std::size_t>(index) >= n_cells || position.At(index) != CellSymbol::EMPTY)
+		{
+			continue;
+		}
+
+		position.MakeMove(index);
+
+		int score = 0;
+
+		if (position.IsWinningMove(index))
+		{
+			score = win_score - (ply + 1);
+		}
+		else
+		{
+			if (accumulator != nullptr)
+			{
+				network_->Update(*accumulator, accumulator + 1, position, index);
+			}
+
+			score = -Negamax(position, accumulator != nullptr ? accumulator + 1 : nullptr, depth - 1, ply + 1, -beta, -alpha, thread_index, nullptr, nodes);
+		}
+
+		position.UnmakeMove(index);
+
+		if (Stopped(thread_index))
+		{
+			return 0;
+		}
+
+		if (score > best_score)
+		{
+			best_score = score;
+			local_best_move = index;
+
+			if (score > alpha)
+			{
+				alpha = score;
+
+				if (alpha >= beta)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	Bound bound = Bound::EXACT;
+
+	if (best_score <= alpha_orig)
+	{
+		bound = Bound::UPPER;
+	}
+	else if (best_score >= beta)
+	{
+		bound = Bound::LOWER;
+	}
+
+	transposition_table_.Store(key, { ScoreToTable(best_score, ply), local_best_move, depth, bound });
+
+	if (best_move != nullptr)
+	{
+		*best_move = local_best_move;
+	}
+
+	return best_score;
+}
+
+bool Search::Stopped(std::size_t thread_index) const
+{
+	return stop_.load(std::memory_order_relaxed) || (thread_index != 0 && helpers_stop_.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,87 @@
+#include "AI/TranspositionTable.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+TranspositionTable::TranspositionTable(std::size_t n_entries) : slots_(nullptr), mask_(0)
+{
+	assert(n_entries > 0 && (n_entries & (n_entries - 1)) == 0);
+
+	slots_ = std::make_unique<Slot[]>(n_entries);
+	mask_ = n_entries - 1;
+
+	Clear();
+}
+
+bool TranspositionTable::Probe(std::uint64_t key, TranspositionEntry* entry) const
+{
+	assert(entry != nullptr);
+
+	const Slot& slot = slots_[key & mask_];
+	const std::uint64_t data = slot.data_.load(std::memory_order_relaxed);
+	const std::uint64_t stored_key = slot.key_.load(std::memory_order_relaxed) ^ data;
+
+	if (stored_key != key)
+	{
+		return false;
+	}
+
+	*entry = Unpack(data);
+
+	return entry->bound_ != Bound::NONE;
+}
+
+void TranspositionTable::Store(std::uint64_t key, const TranspositionEntry& entry)
+{
+	Slot& slot = slots_[key & mask_];
+	const std::uint64_t old_data = slot.data_.load(std::memory_order_relaxed);
+	const std::uint64_t old_key = slot.key_.load(std::memory_order_relaxed) ^ old_data;
+
+	if (old_key == key && entry.depth_ < Unpack(old_data).depth_ && entry.bound_ != Bound::EXACT)
+	{
+		return;
+	}
+
+	const std::uint64_t data = Pack(entry);
+
+	slot.key_.store(key ^ data, std::memory_order_relaxed);
+	slot.data_.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::Clear()
+{
+	for (std::size_t i = 0; i <= mask_; ++i)
+	{
+		slots_[i].key_.store(0, std::memory_order_relaxed);
+		slots_[i].data_.store(0, std::memory_order_relaxed);
+	}
+}
+
+std::size_t TranspositionTable::Size() const
+{
+	return mask_ + 1;
+}
+
+std::uint64_t TranspositionTable::Pack(const TranspositionEntry& entry)
+{
+	const std::uint64_t score = static_cast<std::uint16_t>(static_cast<std::int16_t>(entry.score_));
+	const std::uint64_t best_move = static_cast<std::uint16_t>(static_cast<std::int16_t>(entry.best_move_));
+	const std::uint64_t depth = static_cast<std::uint8_t>(entry.depth_);
+	const std::uint64_t bound = static_cast<std::uint8_t>(entry.bound_);
+
+	return score | (best_move << 16) | (depth << 32) | (bound << 40);
+}
+
+TranspositionEntry TranspositionTable::Unpack(std::uint64_t data)
+{
+	TranspositionEntry entry;
+
+	entry.score_ = static_cast<std::int16_t>(data & 0xFFFF);
+	entry.best_move_ = static_cast<std::int16_t>((data >> 16) & 0xFFFF);
+	entry.depth_ = static_cast<int>((data >> 32) & 0xFF);
+	entry.bound_ = static_cast<Bound>((data >> 40) & 0x3);
+
+	return entry;
+}
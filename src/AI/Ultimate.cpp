@@ -0,0 +1,453 @@
+#include "AI/Ultimate.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/AllocationTracker.hpp"
+#include "Utils/Metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+	constexpr float exploration = 1.4f;
+
+	int PopCount(std::uint16_t bits)
+	{
+		return __builtin_popcount(bits);
+	}
+
+	// nth_cells[mask][k] is the k-th (from 0) cell set in mask, so playouts pick a random empty
+	// cell without a data-dependent loop.
+	constexpr std::array<std::array<std::uint8_t, 9>, 512> GenerateNthCells()
+	{
+		std::array<std::array<std::uint8_t, 9>, 512> nth_cells = {};
+
+		for (int mask = 0; mask < 512; ++mask)
+		{
+			int k = 0;
+
+			for (int cell = 0; cell < 9; ++cell)
+			{
+				if ((mask >> cell) & 1)
+				{
+					nth_cells[mask][k++] = static_cast<std::uint8_t>(cell);
+				}
+			}
+		}
+
+		return nth_cells;
+	}
+
+	constexpr std::array<std::array<std::uint8_t, 9>, 512> nth_cells = GenerateNthCells();
+
+	int NthCell(std::uint16_t mask, int k)
+	{
+		return nth_cells[mask][k];
+	}
+
+	// Maps a 32-bit random number onto [0, n) without a division.
+	int Reduce(std::uint32_t random, int n)
+	{
+		return static_cast<int>((static_cast<std::uint64_t>(random) * static_cast<std::uint32_t>(n)) >> 32);
+	}
+} // namespace
+
+UltimatePosition::UltimatePosition()
+{
+	Reset(CellSymbol::X);
+}
+
+void UltimatePosition::Reset(CellSymbol side_to_move)
+{
+	assert(side_to_move != CellSymbol::EMPTY);
+
+	for (std::array<std::uint16_t, ultimate::n_boards>& side_cells : cells_)
+	{
+		side_cells.fill(0);
+	}
+
+	open_cells_.fill(ultimate::full_mask);
+	n_open_cells_ = ultimate::n_moves;
+	boards_won_ = { 0, 0 };
+	boards_closed_ = 0;
+	next_board_ = -1;
+	side_to_move_ = side_to_move;
+	winner_ = CellSymbol::EMPTY;
+}
+
+void UltimatePosition::MakeMove(int move)
+{
+	assert(IsLegal(move));
+
+	const int board = move / 9;
+	const int cell = move % 9;
+	const std::size_t side = side_to_move_ == CellSymbol::O;
+	const std::uint16_t board_bit = static_cast<std::uint16_t>(1 << board);
+
+	cells_[side][board] |= static_cast<std::uint16_t>(1 << cell);
+	open_cells_[board] &= static_cast<std::uint16_t>(~(1 << cell));
+	--n_open_cells_;
+
+	if (ultimate::winning_masks[cells_[side][board]])
+	{
+		boards_won_[side] |= board_bit;
+		boards_closed_ |= board_bit;
+		n_open_cells_ -= PopCount(open_cells_[board]);
+		open_cells_[board] = 0;
+
+		if (ultimate::winning_masks[boards_won_[side]])
+		{
+			winner_ = side_to_move_;
+		}
+	}
+	else if (open_cells_[board] == 0)
+	{
+		boards_closed_ |= board_bit;
+	}
+
+	// The cell played picks the opponent's board, unless that board is already decided.
+	next_board_ = (boards_closed_ >> cell) & 1 ? -1 : cell;
+	side_to_move_ = side_to_move_ == CellSymbol::X ? CellSymbol::O : CellSymbol::X;
+}
+
+bool UltimatePosition::IsLegal(int move) const
+{
+	if (move < 0 || move >= ultimate::n_moves || IsOver())
+	{
+		return false;
+	}
+
+	const int board = move / 9;
+
+	return (next_board_ == -1 || next_board_ == board) && ((OpenCells(board) >> (move % 9)) & 1);
+}
+
+int UltimatePosition::LegalMoves(std::array<std::uint8_t, ultimate::n_moves>* moves) const
+{
+	if (IsOver())
+	{
+		return 0;
+	}
+
+	int n_moves = 0;
+	const int first_board = next_board_ == -1 ? 0 : next_board_;
+	const int last_board = next_board_ == -1 ? ultimate::n_boards - 1 : next_board_;
+
+	for (int board = first_board; board <= last_board; ++board)
+	{
+		for (std::uint16_t open = open_cells_[board]; open != 0; open &= open - 1)
+		{
+			(*moves)[n_moves++] = static_cast<std::uint8_t>(board * 9 + __builtin_ctz(open));
+		}
+	}
+
+	return n_moves;
+}
+
+int UltimatePosition::RandomMove(std::uint32_t random) const
+{
+	if (next_board_ != -1)
+	{
+		const std::uint16_t open = open_cells_[next_board_];
+		return next_board_ * 9 + NthCell(open, Reduce(random, PopCount(open)));
+	}
+
+	int k = Reduce(random, n_open_cells_);
+
+	for (int board = 0; board < ultimate::n_boards; ++board)
+	{
+		const int n_board_open = PopCount(open_cells_[board]);
+
+		if (k < n_board_open)
+		{
+			return board * 9 + NthCell(open_cells_[board], k);
+		}
+
+		k -= n_board_open;
+	}
+
+	return -1;
+}
+
+bool UltimatePosition::IsOver() const
+{
+	return winner_ != CellSymbol::EMPTY || boards_closed_ == ultimate::full_mask;
+}
+
+CellSymbol UltimatePosition::Winner() const
+{
+	return winner_;
+}
+
+CellSymbol UltimatePosition::BoardWinner(int board) const
+{
+	if ((boards_won_[0] >> board) & 1)
+	{
+		return CellSymbol::X;
+	}
+
+	if ((boards_won_[1] >> board) & 1)
+	{
+		return CellSymbol::O;
+	}
+
+	return CellSymbol::EMPTY;
+}
+
+std::uint16_t UltimatePosition::BoardsWon(CellSymbol symbol) const
+{
+	return boards_won_[symbol == CellSymbol::O];
+}
+
+std::uint16_t UltimatePosition::OpenCells(int board) const
+{
+	return open_cells_[board];
+}
+
+int UltimatePosition::NextBoard() const
+{
+	return next_board_;
+}
+
+CellSymbol UltimatePosition::At(int move) const
+{
+	const int board = move / 9;
+	const int cell = move % 9;
+
+	if ((cells_[0][board] >> cell) & 1)
+	{
+		return CellSymbol::X;
+	}
+
+	if ((cells_[1][board] >> cell) & 1)
+	{
+		return CellSymbol::O;
+	}
+
+	return CellSymbol::EMPTY;
+}
+
+CellSymbol UltimatePosition::SideToMove() const
+{
+	return side_to_move_;
+}
+
+UltimateSearch::UltimateSearch(std::size_t n_nodes, std::uint64_t seed) :
+	nodes_(std::max<std::size_t>(n_nodes, ultimate::n_moves + 1)),
+	n_nodes_(0),
+	random_state_(seed | 1),
+	root_visits_({}),
+	root_wins_({}),
+	stop_(false),
+	deadline_(0)
+{
+}
+
+SearchResult UltimateSearch::Run(const UltimatePosition& position, std::uint64_t max_playouts)
+{
+	const AllocationScope allocations;
+
+	SearchResult result = { -1, 0, 0, 0 };
+
+	stop_ = false;
+	root_visits_.fill(0);
+	root_wins_.fill(0.0f);
+
+	if (position.IsOver())
+	{
+		return result;
+	}
+
+	n_nodes_ = 1;
+	nodes_[0] = { 0, 0, 0.0f, 0, 0 };
+	Expand(&nodes_[0], position);
+
+	const CellSymbol root_side = position.SideToMove();
+
+	// The root plus at most one node per move left in the game.
+	std::array<std::size_t, ultimate::n_moves + 1> path;
+
+	for (std::uint64_t playout = 0; playout < max_playouts; ++playout)
+	{
+		if ((playout & 255) == 0)
+		{
+			const std::int64_t deadline = deadline_.load(std::memory_order_relaxed);
+
+			if (deadline != 0 && std::chrono::steady_clock::now().time_since_epoch().count() >= deadline)
+			{
+				stop_ = true;
+			}
+
+			if (stop_.load(std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+
+		UltimatePosition current = position;
+		std::size_t node_index = 0;
+		int depth = 0;
+
+		path[0] = 0;
+
+		while (nodes_[node_index].n_children_ != 0)
+		{
+			node_index = SelectChild(nodes_[node_index]);
+			current.MakeMove(nodes_[node_index].move_);
+			path[++depth] = node_index;
+		}
+
+		Node& leaf = nodes_[node_index];
+
+		if (!current.IsOver() && leaf.visits_ >= constants::ultimate_mcts_expand_visits)
+		{
+			Expand(&leaf, current);
+
+			if (leaf.n_children_ != 0)
+			{
+				node_index = leaf.first_child_;
+				current.MakeMove(nodes_[node_index].move_);
+				path[++depth] = node_index;
+			}
+		}
+
+		const CellSymbol winner = current.IsOver() ? current.Winner() : Playout(current);
+
+		for (int i = 0; i <= depth; ++i)
+		{
+			Node& node = nodes_[path[i]];
+
+			// Odd depths were reached by a move of the root's side to move.
+			const CellSymbol mover = i % 2 == 1 ? root_side : Position::Opponent(root_side);
+
+			++node.visits_;
+			node.wins_ += winner == mover ? 1.0f : (winner == CellSymbol::EMPTY ? 0.5f : 0.0f);
+		}
+
+		result.depth_ = std::max(result.depth_, depth);
+		++result.nodes_;
+	}
+
+	Metrics::Instance().MctsPlayouts().Add(result.nodes_);
+
+	const Node& root = nodes_[0];
+	std::uint32_t best_visits = 0;
+
+	for (std::size_t i = 0; i < root.n_children_; ++i)
+	{
+		const Node& child = nodes_[root.first_child_ + i];
+
+		root_visits_[child.move_] = child.visits_;
+		root_wins_[child.move_] = child.wins_;
+
+		if (result.best_move_ == -1 || child.visits_ > best_visits)
+		{
+			best_visits = child.visits_;
+			result.best_move_ = child.move_;
+			result.score_ = child.visits_ != 0 ? static_cast<int>(1000.0f * child.wins_ / child.visits_) : 500;
+		}
+	}
+
+	AllocationTracker::ExpectNone("mcts search", allocations.Stats());
+
+	return result;
+}
+
+const std::array<std::uint32_t, ultimate::n_moves>& UltimateSearch::RootVisits() const
+{
+	return root_visits_;
+}
+
+const std::array<float, ultimate::n_moves>& UltimateSearch::RootWins() const
+{
+	return root_wins_;
+}
+
+void UltimateSearch::Stop()
+{
+	stop_ = true;
+}
+
+void UltimateSearch::SetDeadline(std::chrono::steady_clock::time_point deadline)
+{
+	deadline_ = std::max<std::int64_t>(1, deadline.time_since_epoch().count());
+}
+
+void UltimateSearch::ClearDeadline()
+{
+	deadline_ = 0;
+}
+
+std::uint32_t UltimateSearch::Random()
+{
+	// xorshift64*
+	random_state_ ^= random_state_ >> 12;
+	random_state_ ^= random_state_ << 25;
+	random_state_ ^= random_state_ >> 27;
+
+	return static_cast<std::uint32_t>((random_state_ * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+std::size_t UltimateSearch::SelectChild(const Node& node) const
+{
+	const float log_visits = std::log(static_cast<float>(node.visits_));
+
+	std::size_t best_child = node.first_child_;
+	float best_value = -std::numeric_limits<float>::infinity();
+
+	for (std::size_t i = node.first_child_; i < node.first_child_ + node.n_children_; ++i)
+	{
+		const Node& child = nodes_[i];
+
+		if (child.visits_ == 0)
+		{
+			return i;
+		}
+
+		const float visits = static_cast<float>(child.visits_);
+		const float value = child.wins_ / visits + exploration * std::sqrt(log_visits / visits);
+
+		if (value > best_value)
+		{
+			best_value = value;
+			best_child = i;
+		}
+	}
+
+	return best_child;
+}
+
+void UltimateSearch::Expand(Node* node, const UltimatePosition& position)
+{
+	std::array<std::uint8_t, ultimate::n_moves> moves;
+	const int n_moves = position.LegalMoves(&moves);
+
+	if (n_moves == 0 || n_nodes_ + n_moves > nodes_.size())
+	{
+		return;
+	}
+
+	node->first_child_ = static_cast<std::uint32_t>(n_nodes_);
+	node->n_children_ = static_cast<std::uint8_t>(n_moves);
+
+	for (int i = 0; i < n_moves; ++i)
+	{
+		nodes_[n_nodes_++] = { 0, 0, 0.0f, 0, moves[i] };
+	}
+}
+
+CellSymbol UltimateSearch::Playout(UltimatePosition position)
+{
+	while (!position.IsOver())
+	{
+		position.MakeMove(position.RandomMove(Random()));
+	}
+
+	return position.Winner();
+}
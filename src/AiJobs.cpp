@@ -0,0 +1,48 @@
+#include "Utils/ThreadPool.hpp"
+#include "AiJobs.hpp"
+#include "Game.hpp"
+
+#include <functional>
+#include <thread>
+#include <utility>
+
+AiJobs::AiJobs() : game_(nullptr), n_running_(0)
+{
+}
+
+void AiJobs::Attach(Game* game)
+{
+	game_ = game;
+}
+
+std::size_t AiJobs::Workers() const
+{
+	return game_->AiPool()->Workers();
+}
+
+void AiJobs::Submit(std::function<void(std::size_t)> job)
+{
+	n_running_.fetch_add(1, std::memory_order_relaxed);
+
+	// The pool's job queue grows in blocks, so a submission may allocate.
+	game_->AllowFrameAllocations();
+
+	game_->AiPool()->Submit([this, job = std::move(job)](std::size_t worker_index)
+	{
+		job(worker_index);
+		n_running_.fetch_sub(1, std::memory_order_release);
+	});
+}
+
+bool AiJobs::Running() const
+{
+	return n_running_.load(std::memory_order_acquire) != 0;
+}
+
+void AiJobs::Wait()
+{
+	while (Running())
+	{
+		std::this_thread::yield();
+	}
+}
@@ -0,0 +1,139 @@
+#include "Audio.hpp"
+#include "Utils/AssetPack.hpp"
+#include "Utils/Constants.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+	constexpr const char* sound_names[] = { "sfx/place.wav", "sfx/win.wav", "sfx/tie.wav" };
+} // namespace
+
+Audio::Audio() : chunks_({}), open_(false), frequency_(0), buffer_samples_(0), pending_click_(0)
+{
+}
+
+Audio::~Audio()
+{
+	Close();
+}
+
+bool Audio::Open()
+{
+	if (Mix_OpenAudio(constants::audio_frequency, AUDIO_S16SYS, 2, constants::audio_buffer_samples) < 0)
+	{
+		printf("SDL_mixer could not be initialized! SDL_mixer Error: %s\n", Mix_GetError());
+		return false;
+	}
+
+	open_ = true;
+
+	Uint16 format = 0;
+	int channels = 0;
+	Mix_QuerySpec(&frequency_, &format, &channels);
+	buffer_samples_ = constants::audio_buffer_samples;
+
+	Mix_AllocateChannels(constants::audio_channels);
+
+	for (std::size_t i = 0; i < n_sounds; ++i)
+	{
+		chunks_[i] = AssetPack::Instance().LoadChunk(sound_names[i]);
+
+		if (chunks_[i] == nullptr)
+		{
+			printf("Failed to load sound %s! SDL_mixer Error: %s\n", sound_names[i], Mix_GetError());
+		}
+	}
+
+	Mix_SetPostMix(&Audio::PostMix, this);
+
+	printf("Audio: %d Hz, %d-sample buffer (%.1f ms)\n", frequency_, buffer_samples_, 1000.0 * buffer_samples_ / frequency_);
+
+	return true;
+}
+
+void Audio::Close()
+{
+	if (!open_)
+	{
+		return;
+	}
+
+	Mix_HaltChannel(-1);
+	Mix_SetPostMix(nullptr, nullptr);
+
+	for (Mix_Chunk*& chunk : chunks_)
+	{
+		Mix_FreeChunk(chunk);
+		chunk = nullptr;
+	}
+
+	Mix_CloseAudio();
+	open_ = false;
+}
+
+void Audio::Play(Sound sound, std::uint64_t click_counter)
+{
+	Mix_Chunk* chunk = chunks_[static_cast<int>(sound)];
+
+	if (!open_ || chunk == nullptr)
+	{
+		return;
+	}
+
+	// Only takes the mixer lock long enough to claim a channel; a new effect cuts off the oldest
+	// one when all channels are busy.
+	if (Mix_PlayChannel(-1, chunk, 0) == -1)
+	{
+		Mix_HaltChannel(Mix_GroupOldest(-1));
+		Mix_PlayChannel(-1, chunk, 0);
+	}
+
+	// Stored once the channel is playing, so the next post-mix has mixed this sound.
+	if (click_counter != 0)
+	{
+		pending_click_.store(click_counter, std::memory_order_release);
+	}
+}
+
+void Audio::Report()
+{
+	std::uint64_t latency_us = 0;
+
+	while (click_to_mix_us_queue_.Pop(&latency_us))
+	{
+		click_to_mix_us_.Record(latency_us);
+	}
+
+	if (click_to_mix_us_.Count() == 0 || frequency_ == 0)
+	{
+		return;
+	}
+
+	// Mixed audio still has to play out of the device buffer, which adds up to one buffer.
+	const std::uint64_t buffer_us = static_cast<std::uint64_t>(buffer_samples_) * 1000000 / frequency_;
+
+	printf("Audio latency us (n=%llu) click->mixed p50: %llu p99: %llu max: %llu, +%llu device buffer\n",
+		static_cast<unsigned long long>(click_to_mix_us_.Count()),
+		static_cast<unsigned long long>(click_to_mix_us_.Percentile(50.0)),
+		static_cast<unsigned long long>(click_to_mix_us_.Percentile(99.0)),
+		static_cast<unsigned long long>(click_to_mix_us_.Max()),
+		static_cast<unsigned long long>(buffer_us));
+
+	click_to_mix_us_.Reset();
+}
+
+void Audio::PostMix(void* user_data, Uint8*, int)
+{
+	Audio* audio = static_cast<Audio*>(user_data);
+	const std::uint64_t click_counter = audio->pending_click_.exchange(0, std::memory_order_acquire);
+
+	if (click_counter != 0)
+	{
+		audio->click_to_mix_us_queue_.Push((SDL_GetPerformanceCounter() - click_counter) * 1000000 / SDL_GetPerformanceFrequency());
+	}
+}
@@ -0,0 +1,163 @@
+#include "BoardBatch.hpp"
+#include "BoardRenderer.hpp"
+#include "SpriteSheet.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstdio>
+
+namespace
+{
+	// Quads per board: every cell's background, win highlight and symbol.
+	constexpr std::size_t max_board_quads = 9 * 3;
+} // namespace
+
+BoardBatch::BoardBatch() : renderer_(nullptr), atlas_(nullptr), cell_side_(1), separator_width_(1)
+{
+}
+
+BoardBatch::~BoardBatch()
+{
+	Free();
+}
+
+bool BoardBatch::Initialize(SDL_Renderer* renderer, std::size_t max_boards)
+{
+	renderer_ = renderer;
+
+	vertices_.reserve(max_boards * max_board_quads * 4);
+	indices_.reserve(max_boards * max_board_quads * 6);
+
+	if (!symbols_sheet_.Load("gfx/symbols.png", 2))
+	{
+		printf("Failed to load symbols texture!\n");
+		return false;
+	}
+
+	return true;
+}
+
+bool BoardBatch::Layout(int cell_side, int separator_width)
+{
+	cell_side_ = cell_side;
+	separator_width_ = separator_width;
+
+	symbols_sheet_.ClearCache();
+	Texture* symbols_texture = symbols_sheet_.Get(renderer_, cell_side_);
+
+	if (symbols_texture == nullptr)
+	{
+		printf("Failed to scale symbols texture!\n");
+		return false;
+	}
+
+	if (atlas_ != nullptr)
+	{
+		SDL_DestroyTexture(atlas_);
+	}
+
+	// [O][X][white]: the white block is sampled at its centre for untextured quads.
+	atlas_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, 3 * cell_side_, cell_side_);
+
+	if (atlas_ == nullptr)
+	{
+		printf("Unable to create board atlas! SDL Error: %s\n", SDL_GetError());
+		return false;
+	}
+
+	SDL_SetTextureBlendMode(atlas_, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderTarget(renderer_, atlas_);
+
+	SDL_SetRenderDrawColor(renderer_, 0x00, 0x00, 0x00, 0x00);
+	SDL_RenderClear(renderer_);
+
+	// Copied without blending so the sprites' alpha lands in the atlas unchanged.
+	const SDL_Rect symbols_rect = { 0, 0, 2 * cell_side_, cell_side_ };
+	SDL_SetTextureBlendMode(symbols_texture->GetTexture(), SDL_BLENDMODE_NONE);
+	SDL_RenderCopy(renderer_, symbols_texture->GetTexture(), NULL, &symbols_rect);
+	SDL_SetTextureBlendMode(symbols_texture->GetTexture(), SDL_BLENDMODE_BLEND);
+
+	const SDL_Rect white_rect = { 2 * cell_side_, 0, cell_side_, cell_side_ };
+	SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
+	SDL_RenderFillRect(renderer_, &white_rect);
+
+	SDL_SetRenderTarget(renderer_, NULL);
+
+	return true;
+}
+
+int BoardBatch::BoardSide() const
+{
+	return 3 * cell_side_ + 2 * separator_width_;
+}
+
+void BoardBatch::Begin()
+{
+	vertices_.clear();
+	indices_.clear();
+}
+
+void BoardBatch::AddBoard(const BoardSnapshot& snapshot, int x, int y, float alpha)
+{
+	const float side = static_cast<float>(cell_side_);
+	const float white_u = 5.0f / 6.0f;
+
+	for (std::size_t i = 0; i < snapshot.symbols_.size(); ++i)
+	{
+		const float cell_x = static_cast<float>(x + static_cast<int>(i % 3) * (cell_side_ + separator_width_));
+		const float cell_y = static_cast<float>(y + static_cast<int>(i / 3) * (cell_side_ + separator_width_));
+
+		AddQuad(cell_x, cell_y, side, { 0xFF, 0xFF, 0xFF, 0xFF }, white_u, white_u);
+
+		if (snapshot.render_win_[i])
+		{
+			const float win_fade = snapshot.win_fade_[i] + (snapshot.win_fade_next_[i] - snapshot.win_fade_[i]) * alpha;
+
+			AddQuad(cell_x, cell_y, side, { 0x00, 0xB4, 0x00, static_cast<Uint8>(win_fade * 0xFF) }, white_u, white_u);
+		}
+
+		if (snapshot.symbols_[i] != CellSymbol::EMPTY)
+		{
+			const float symbol_fade = snapshot.symbol_fade_[i] + (snapshot.symbol_fade_next_[i] - snapshot.symbol_fade_[i]) * alpha;
+			const float u0 = snapshot.symbols_[i] == CellSymbol::X ? 1.0f / 3.0f : 0.0f;
+
+			AddQuad(cell_x, cell_y, side, { 0xFF, 0xFF, 0xFF, static_cast<Uint8>(symbol_fade * 0xFF) }, u0, u0 + 1.0f / 3.0f);
+		}
+	}
+}
+
+void BoardBatch::Submit()
+{
+	if (atlas_ == nullptr || indices_.empty())
+	{
+		return;
+	}
+
+	SDL_RenderGeometry(renderer_, atlas_, vertices_.data(), static_cast<int>(vertices_.size()), indices_.data(), static_cast<int>(indices_.size()));
+}
+
+void BoardBatch::Free()
+{
+	if (atlas_ != nullptr)
+	{
+		SDL_DestroyTexture(atlas_);
+		atlas_ = nullptr;
+	}
+
+	symbols_sheet_.Free();
+}
+
+void BoardBatch::AddQuad(float x, float y, float side, const SDL_Color& colour, float u0, float u1)
+{
+	const int first = static_cast<int>(vertices_.size());
+
+	vertices_.push_back({ { x, y }, colour, { u0, 0.0f } });
+	vertices_.push_back({ { x + side, y }, colour, { u1, 0.0f } });
+	vertices_.push_back({ { x + side, y + side }, colour, { u1, 1.0f } });
+	vertices_.push_back({ { x, y + side }, colour, { u0, 1.0f } });
+
+	for (const int corner : { 0, 1, 2, 0, 2, 3 })
+	{
+		indices_.push_back(first + corner);
+	}
+}
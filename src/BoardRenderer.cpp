@@ -0,0 +1,313 @@
+#include "AI/Analysis.hpp"
+#include "AI/Search.hpp"
+#include "Utils/AssetPack.hpp"
+#include "BoardRenderer.hpp"
+#include "SpriteSheet.hpp"
+#include "Texture.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace
+{
+	// Green for cells that are good for the side to move, red for bad ones, more opaque the
+	// clearer the verdict. Forced results saturate; heuristic scores ramp up to a few strong
+	// threats' worth.
+	SDL_Color HeatColour(int score)
+	{
+		float strength = std::clamp(score / 1000.0f, -1.0f, 1.0f);
+
+		if (score > Search::win_threshold || score < -Search::win_threshold)
+		{
+			strength = score > 0 ? 1.0f : -1.0f;
+		}
+
+		const Uint8 alpha = static_cast<Uint8>(0x30 + std::abs(strength) * 0x90);
+
+		if (strength > 0.0f)
+		{
+			return { 0x00, 0xB4, 0x00, alpha };
+		}
+
+		if (strength < 0.0f)
+		{
+			return { 0xD2, 0x1E, 0x1E, alpha };
+		}
+
+		return { 0x80, 0x80, 0x80, alpha };
+	}
+} // namespace
+
+std::mutex BoardRenderer::text_mutex_;
+
+BoardRenderer::BoardRenderer() : 
+	renderer_(nullptr), 
+	font_(nullptr), 
+	board_viewport_({ 0, 0, 0, 0 }),
+	score_viewport_({ 0, 0, 0, 0 }),
+	cell_side_(1), 
+	info_symbol_side_(1), 
+	x_score_(0), 
+	o_score_(0)
+{
+}
+
+BoardRenderer::~BoardRenderer()
+{
+	Free();
+}
+
+bool BoardRenderer::Initialize(SDL_Renderer* renderer)
+{
+	renderer_ = renderer;
+
+	if (!symbols_sheet_.Load("gfx/symbols.png", 2))
+	{
+		printf("Failed to load symbols texture!\n");
+		return false;
+	}
+
+	return true;
+}
+
+bool BoardRenderer::Layout(int width, int height, double ui_scale, int x_score, int o_score)
+{
+	board_viewport_.x = 0;
+	board_viewport_.y = 0;
+	board_viewport_.w = width;
+	board_viewport_.h = height * 9.0 / 12.0;
+
+	score_viewport_.x = 0;
+	score_viewport_.y = board_viewport_.h;
+	score_viewport_.w = width;
+	score_viewport_.h = height - board_viewport_.h;
+
+	const int rect_separator_width = std::max(1, static_cast<int>(15 * ui_scale));
+	const int board_side = std::min(board_viewport_.w, board_viewport_.h);
+
+	cell_side_ = std::max(1, (board_side - (2 * rect_separator_width)) / 3);
+	info_symbol_side_ = std::max(1, cell_side_ / 4);
+
+	const int board_x = (board_viewport_.w - (3 * cell_side_ + 2 * rect_separator_width)) / 2;
+	const int board_y = (board_viewport_.h - (3 * cell_side_ + 2 * rect_separator_width)) / 2;
+
+	for (std::size_t i = 0; i < cell_rects_.size(); ++i)
+	{
+		cell_rects_[i].x = board_x + static_cast<int>(i % 3) * (cell_side_ + rect_separator_width);
+		cell_rects_[i].y = board_y + static_cast<int>(i / 3) * (cell_side_ + rect_separator_width);
+		cell_rects_[i].w = cell_side_;
+		cell_rects_[i].h = cell_side_;
+	}
+
+	symbols_sheet_.ClearCache();
+
+	{
+		std::lock_guard<std::mutex> lock(text_mutex_);
+
+		TTF_Font* font = AssetPack::Instance().OpenFont("font/font.ttf", std::max(1, static_cast<int>(48 * ui_scale)));
+
+		if (font == nullptr)
+		{
+			printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
+			return false;
+		}
+
+		TTF_CloseFont(font_);
+		font_ = font;
+	}
+
+	message_textures_.resize(4);
+
+	for (std::unique_ptr<Texture>& message_texture : message_textures_)
+	{
+		message_texture = std::make_unique<Texture>();
+	}
+
+	x_score_ = x_score;
+	o_score_ = o_score;
+
+	return LoadText(MessageType::TIE, "TIE") && 
+		LoadText(MessageType::MENU, "Press M for menu") && 
+		LoadText(MessageType::X_SCORE, std::to_string(x_score_).c_str()) && 
+		LoadText(MessageType::O_SCORE, std::to_string(o_score_).c_str());
+}
+
+bool BoardRenderer::LoadText(MessageType type, const char* text)
+{
+	std::lock_guard<std::mutex> lock(text_mutex_);
+
+	if (!message_textures_[static_cast<int>(type)]->LoadFromText(renderer_, font_, text, { 0x00, 0x00, 0x00, 0xFF }))
+	{
+		printf("Failed to render text!\n");
+		return false;
+	}
+
+	return true;
+}
+
+int BoardRenderer::CellAt(int x, int y) const
+{
+	const SDL_Point mouse_position = { x, y };
+
+	for (std::size_t i = 0; i < cell_rects_.size(); ++i)
+	{
+		if (SDL_PointInRect(&mouse_position, &cell_rects_[i]))
+		{
+			return static_cast<int>(i);
+		}
+	}
+
+	return -1;
+}
+
+void BoardRenderer::Render(const BoardSnapshot& snapshot, float alpha, bool single_player, const AnalysisResult* analysis)
+{
+	SDL_SetRenderDrawColor(renderer_, 0x00, 0x00, 0x00, 0xFF);
+	SDL_RenderClear(renderer_);
+
+	RenderBoard(snapshot, alpha, analysis);
+	RenderInfo(snapshot, single_player);
+}
+
+void BoardRenderer::RenderBoard(const BoardSnapshot& snapshot, float alpha, const AnalysisResult* analysis)
+{
+	SDL_RenderSetViewport(renderer_, &board_viewport_);
+	SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
+
+	Texture* symbols_texture = symbols_sheet_.Get(renderer_, cell_side_);
+
+	for (std::size_t i = 0; i < cell_rects_.size(); ++i)
+	{
+		const SDL_Rect& cell_rect = cell_rects_[i];
+
+		SDL_RenderFillRect(renderer_, &cell_rect);
+
+		if (snapshot.render_win_[i])
+		{
+			const float win_fade = snapshot.win_fade_[i] + (snapshot.win_fade_next_[i] - snapshot.win_fade_[i]) * alpha;
+
+			SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
+			SDL_SetRenderDrawColor(renderer_, 0x00, 0xB4, 0x00, static_cast<Uint8>(win_fade * 0xFF));
+			SDL_RenderFillRect(renderer_, &cell_rect);
+			SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_NONE);
+			SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
+		}
+
+		if (analysis != nullptr && snapshot.symbols_[i] == CellSymbol::EMPTY && analysis->depths_[i] != 0)
+		{
+			const SDL_Color colour = HeatColour(analysis->scores_[i]);
+
+			SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
+			SDL_SetRenderDrawColor(renderer_, colour.r, colour.g, colour.b, colour.a);
+			SDL_RenderFillRect(renderer_, &cell_rect);
+			SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_NONE);
+			SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
+		}
+
+		if (snapshot.symbols_[i] != CellSymbol::EMPTY && symbols_texture != nullptr)
+		{
+			SDL_Rect symbol_clip = symbols_sheet_.Clip(snapshot.symbols_[i] == CellSymbol::X, cell_side_);
+			const float symbol_fade = snapshot.symbol_fade_[i] + (snapshot.symbol_fade_next_[i] - snapshot.symbol_fade_[i]) * alpha;
+
+			symbols_texture->SetAlpha(static_cast<Uint8>(symbol_fade * 0xFF));
+			symbols_texture->Render(renderer_, cell_rect.x, cell_rect.y, &symbol_clip, 1.0);	
+			symbols_texture->SetAlpha(0xFF);
+		}
+	}
+	
+	SDL_RenderSetViewport(renderer_, NULL);
+}
+
+void BoardRenderer::RenderInfo(const BoardSnapshot& snapshot, bool single_player)
+{
+	// Score textures are only re-rendered when a score actually changes.
+	if (snapshot.x_score_ != x_score_)
+	{
+		x_score_ = snapshot.x_score_;
+		LoadText(MessageType::X_SCORE, std::to_string(x_score_).c_str());
+	}
+
+	if (snapshot.o_score_ != o_score_)
+	{
+		o_score_ = snapshot.o_score_;
+		LoadText(MessageType::O_SCORE, std::to_string(o_score_).c_str());
+	}
+
+	SDL_RenderSetViewport(renderer_, &score_viewport_);
+	SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
+
+	const SDL_Rect info_background_rect = { 0, 0, score_viewport_.w, score_viewport_.h };
+	SDL_RenderFillRect(renderer_, &info_background_rect);
+
+	Texture* symbols_texture = symbols_sheet_.Get(renderer_, info_symbol_side_);
+	SDL_Rect o_clip = symbols_sheet_.Clip(0, info_symbol_side_);
+	SDL_Rect x_clip = symbols_sheet_.Clip(1, info_symbol_side_);
+
+	const int o_x = score_viewport_.w * 2 / 7;
+	const int o_y = score_viewport_.h * 1 / 6;
+
+	const int x_x = score_viewport_.w * 5 / 7 - info_symbol_side_;
+	const int x_y = score_viewport_.h * 1 / 6;
+
+	if (symbols_texture != nullptr)
+	{
+		symbols_texture->Render(renderer_, o_x, o_y, &o_clip, 1.0);
+		symbols_texture->Render(renderer_, x_x, x_y, &x_clip, 1.0);
+	}
+
+	const int x_score_msg_index = static_cast<int>(MessageType::X_SCORE);
+	const int o_score_msg_index = static_cast<int>(MessageType::O_SCORE);
+
+	message_textures_[o_score_msg_index]->Render(renderer_, o_x + ((info_symbol_side_ / 2) - message_textures_[o_score_msg_index]->Width() / 2), score_viewport_.h / 2);
+	message_textures_[x_score_msg_index]->Render(renderer_, x_x + ((info_symbol_side_ / 2) - message_textures_[x_score_msg_index]->Width() / 2), score_viewport_.h / 2);
+
+	if (!snapshot.win_)
+	{
+		SDL_SetRenderDrawColor(renderer_, 0x00, 0x00, 0x00, 0xFF);
+
+		if (snapshot.free_cells_ == 0)
+		{
+			const int tie_msg_index = static_cast<int>(MessageType::TIE);
+
+			message_textures_[tie_msg_index]->Render(renderer_, 
+													(score_viewport_.w / 2) - (message_textures_[tie_msg_index]->Width() / 2), 
+													o_y * 2);
+		}
+		else
+		{
+			const int line_x = (snapshot.player_turn_ || single_player) ? x_x : o_x;
+			const int line_y = (snapshot.player_turn_ || single_player) ? x_y : o_y;
+
+			for (std::size_t i = 5; i < 10; ++i)
+			{
+				SDL_RenderDrawLine(renderer_, line_x, line_y + i + info_symbol_side_, line_x + info_symbol_side_, line_y + i + info_symbol_side_);
+			}
+		}
+		
+		SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);	
+	}
+
+	const int menu_msg_index = static_cast<int>(MessageType::MENU);
+
+	message_textures_[menu_msg_index]->Render(renderer_, (score_viewport_.w / 2) - (message_textures_[menu_msg_index]->Width() / 2), score_viewport_.h - message_textures_[menu_msg_index]->Height());
+
+	SDL_RenderSetViewport(renderer_, NULL);
+}
+
+void BoardRenderer::Free()
+{
+	message_textures_.clear();
+	symbols_sheet_.Free();
+
+	std::lock_guard<std::mutex> lock(text_mutex_);
+
+	TTF_CloseFont(font_);
+	font_ = nullptr;
+}
@@ -1,5 +1,8 @@
 #include "Button.hpp"
 #include "States/BoardState.hpp"
+#include "States/ExhibitionState.hpp"
+#include "States/QubicState.hpp"
+#include "States/UltimateState.hpp"
 
 Button::Button(Game* game, TTF_Font* font) : 
 	game_(game),
@@ -19,12 +22,18 @@ void Button::SetPosition(int x, int y)
 	top_left_.y = y;
 }
 
+void Button::SetFont(TTF_Font* font)
+{
+	font_ = font;
+	reload_ = true;
+}
+
 void Button::SetText(const std::string& text)
 {
 	text_ = text;
 }
 
-std::string Button::Text()
+const std::string& Button::Text() const
 {
 	return text_;
 }
@@ -78,8 +87,26 @@ void Button::HandleEvent(SDL_Event* e)
 	}
 	else if (e->type == SDL_MOUSEBUTTONUP && MouseOverlapsButton())
 	{
-		game_->SetGameMode(text_ == "Singleplayer" ? GameMode::SINGLE_PLAYER : GameMode::MULTI_PLAYER);
-		game_->PushState(BoardState::Instance());
+		if (text_ == "Exhibition")
+		{
+			game_->SetGameMode(GameMode::EXHIBITION);
+			game_->PushState(ExhibitionState::Instance());
+		}
+		else if (text_ == "Qubic")
+		{
+			game_->SetGameMode(GameMode::QUBIC);
+			game_->PushState(QubicState::Instance());
+		}
+		else if (text_ == "Ultimate")
+		{
+			game_->SetGameMode(GameMode::ULTIMATE);
+			game_->PushState(UltimateState::Instance());
+		}
+		else
+		{
+			game_->SetGameMode(text_ == "Singleplayer" ? GameMode::SINGLE_PLAYER : GameMode::MULTI_PLAYER);
+			game_->PushState(BoardState::Instance());
+		}
 	}
 }
 
@@ -106,6 +133,13 @@ void Button::Tick(bool force_update)
 	}
 }
 
+bool Button::LoadFromSurface(SDL_Surface* surface)
+{
+	reload_ = false;
+
+	return button_texture_->LoadFromSurface(game_->GetRenderer(), surface);
+}
+
 void Button::Render(SDL_Renderer* renderer)
 {
 	button_texture_->Render(renderer, top_left_.x, top_left_.y);
@@ -120,6 +154,7 @@ bool Button::MouseOverlapsButton() const
 {
 	SDL_Point mouse_position;
 	SDL_GetMouseState(&mouse_position.x, &mouse_position.y);
+	game_->WindowToRenderer(&mouse_position.x, &mouse_position.y);
 	
 	SDL_Rect button_bounding_box = { top_left_.x, top_left_.y, button_texture_->Width(), button_texture_->Height() };
 
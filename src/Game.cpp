@@ -1,11 +1,20 @@
 #include "States/MenuState.hpp"
+#include "Utils/AllocationTracker.hpp"
+#include "Utils/AssetPack.hpp"
 #include "Utils/Constants.hpp"
+#include "Utils/Metrics.hpp"
 #include "Game.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
 #include <iostream>
+#include <memory>
 
 Game::Game() : 
 	title_(constants::game_title), 
@@ -13,8 +22,13 @@ Game::Game() :
 	screen_height_(constants::screen_height), 
 	is_running_(false),
 	game_mode_(GameMode::NONE),
+	tick_rate_(constants::default_tick_rate),
+	max_catch_up_ticks_(constants::max_catch_up_ticks),
+	smoothed_frame_time_(1.0 / constants::default_tick_rate),
+	start_time_(std::chrono::steady_clock::now()),
 	window_(nullptr),
-	renderer_(nullptr)
+	renderer_(nullptr),
+	frame_may_allocate_(false)
 {
 }
 
@@ -44,20 +58,105 @@ SDL_Renderer* Game::GetRenderer()
 	return renderer_;
 }
 
+InputLatency* Game::GetInputLatency()
+{
+	return &input_latency_;
+}
+
+Audio* Game::GetAudio()
+{
+	return &audio_;
+}
+
+ThreadPool* Game::AiPool()
+{
+	if (ai_pool_ == nullptr)
+	{
+		ai_pool_ = std::make_unique<ThreadPool>();
+	}
+
+	return ai_pool_.get();
+}
+
+void Game::UpdateScreenSize()
+{
+	SDL_GetRendererOutputSize(renderer_, &screen_width_, &screen_height_);
+}
+
+int Game::ScreenWidth()
+{
+	return screen_width_;
+}
+
+int Game::ScreenHeight()
+{
+	return screen_height_;
+}
+
+double Game::UiScale()
+{
+	return std::min(static_cast<double>(screen_width_) / constants::screen_width, static_cast<double>(screen_height_) / constants::screen_height);
+}
+
+void Game::WindowToRenderer(int* x, int* y)
+{
+	// Mouse events arrive in window points; on Hi-DPI displays the renderer has more pixels than that.
+	int window_width = 0;
+	int window_height = 0;
+	SDL_GetWindowSize(window_, &window_width, &window_height);
+
+	if (window_width > 0 && window_height > 0)
+	{
+		*x = *x * screen_width_ / window_width;
+		*y = *y * screen_height_ / window_height;
+	}
+}
+
 bool Game::Initialize()
 {
+	// SDL_image, SDL_ttf and the asset pack do not depend on the video subsystem, so they come up
+	// on a worker while the window and renderer are created.
+	std::future<bool> libraries = std::async(std::launch::async, []()
+	{
+		constexpr int img_flags = IMG_INIT_PNG;
+
+		if (!(IMG_Init(img_flags) & img_flags))
+		{
+			printf("SDL_image could not be initialized! SDL_image Error: %s\n", IMG_GetError());
+			return false;
+		}
+
+		if (TTF_Init() == -1)
+		{
+			printf("SDL_ttf could not be initialized! SDL_ttf Error: %s\n", TTF_GetError());
+			return false;
+		}
+
+		AssetPack::Instance().Mount();
+
+		return true;
+	});
+
 	if (SDL_Init(SDL_INIT_VIDEO) < 0)
 	{
 		printf("SDL could not be initialized! SDL Error: %s\n", SDL_GetError());
 		return false;
 	}
 
+	// Kiosks and CI boxes may have no audio backend at all; the game then runs silent.
+	const bool audio_available = SDL_InitSubSystem(SDL_INIT_AUDIO) == 0;
+
+	if (!audio_available)
+	{
+		printf("SDL audio could not be initialized, running without sound! SDL Error: %s\n", SDL_GetError());
+	}
+
 	if (!SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0"))
 	{
 		printf("%s\n", "Warning: Texture filtering is not enabled!");
 	}
 
-	window_ = SDL_CreateWindow(title_, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, screen_width_, screen_height_, SDL_WINDOW_SHOWN);
+	window_ = SDL_CreateWindow(title_, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, screen_width_, screen_height_, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
 
 	if (window_ == nullptr)
 	{
@@ -73,27 +172,43 @@ bool Game::Initialize()
 		return false;
 	}
 
+	UpdateScreenSize();
 	SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
 
-	constexpr int img_flags = IMG_INIT_PNG;
+	// Show something right away; the menu fills in as soon as its assets arrive.
+	SDL_RenderClear(renderer_);
+	SDL_RenderPresent(renderer_);
+	MarkStartup("first frame");
 
-	if (!(IMG_Init(img_flags) & img_flags))
-	{
-		printf("SDL_image could not be initialized! SDL_image Error: %s\n", IMG_GetError());
-		return false;
-	}
+	const bool libraries_ready = libraries.get();
+	MarkStartup("libraries ready");
 
-	if (TTF_Init() == -1)
+	// Sounds are decoded from the pack, so the device opens once it is mounted. A missing device
+	// is not fatal; the game runs silent.
+	if (libraries_ready && audio_available && audio_.Open())
 	{
-		printf("SDL_ttf could not be initialized! SDL_ttf Error: %s\n", TTF_GetError());
-		return false;
+		MarkStartup("audio ready");
 	}
 
-	return true;
+	return libraries_ready;
+}
+
+void Game::MarkStartup(const char* milestone)
+{
+	const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time_).count();
+
+	printf("Startup: %s after %.1f ms\n", milestone, elapsed);
+}
+
+void Game::AllowFrameAllocations()
+{
+	frame_may_allocate_ = true;
 }
 
 void Game::ChangeState(GameState* state)
 {
+	AllowFrameAllocations();
+
 	if (!states_.empty())
 	{
 		states_.top()->Exit();
@@ -106,6 +221,8 @@ void Game::ChangeState(GameState* state)
 	
 void Game::PushState(GameState* state)
 {
+	AllowFrameAllocations();
+
 	if (!states_.empty())
 	{
 		states_.top()->Pause();
@@ -117,6 +234,8 @@ void Game::PushState(GameState* state)
 
 void Game::PopState()
 {
+	AllowFrameAllocations();
+
 	if (!states_.empty())
 	{
 		states_.top()->Exit();
@@ -131,6 +250,9 @@ void Game::PopState()
 
 void Game::Finalize()
 {
+	audio_.Close();
+	Mix_Quit();
+
 	SDL_DestroyWindow(window_);
 	window_ = nullptr;
 	
@@ -153,8 +275,6 @@ void Game::Run()
 	is_running_ = true;
 	ChangeState(MenuState::Instance());
 
-	constexpr long double ms = 1.0 / 60.0;
-
 	std::uint64_t last_time = SDL_GetPerformanceCounter();
 	long double delta = 0.0;
 
@@ -162,34 +282,74 @@ void Game::Run()
 
 	int frames = 0;
 	int ticks = 0;
+	std::uint64_t total_frames = 0;
+
+	AllocationStats frame_allocations = { 0, 0 };
+	std::uint64_t max_frame_allocations = 0;
 
 	while (is_running_)
 	{
+		const AllocationScope frame_scope;
+		frame_may_allocate_ = false;
+
 		const std::uint64_t now = SDL_GetPerformanceCounter();
 		const long double elapsed = static_cast<long double>(now - last_time) / static_cast<long double>(SDL_GetPerformanceFrequency());
 		
 		last_time = now;
-		delta += elapsed;
+		Metrics::Instance().FrameTime().Record(static_cast<std::uint64_t>(elapsed * 1000000.0));
+
+		// A stall (slow AI move, window drag) is clamped and smoothed instead of being replayed
+		// as a burst of back-to-back ticks.
+		const long double frame_time = std::min<long double>(elapsed, constants::max_frame_time);
+		smoothed_frame_time_ += constants::frame_time_smoothing * (frame_time - smoothed_frame_time_);
+		delta += smoothed_frame_time_;
 
 		HandleEvents();
 
-		while (delta >= ms)
+		const long double tick_time = 1.0 / tick_rate_;
+		int catch_up_ticks = 0;
+
+		while (delta >= tick_time && catch_up_ticks < max_catch_up_ticks_)
 		{
 			Tick();
-			delta -= ms;
+			delta -= tick_time;
 			++ticks;
+			++catch_up_ticks;
 		}
 
-		//printf("%Lf\n", delta / ms);
-		Render();
+		if (delta >= tick_time)
+		{
+			delta = std::fmod(delta, tick_time);
+		}
+
+		Render(static_cast<double>(delta / tick_time));
 		++frames;
+		++total_frames;
 
 		if (SDL_GetTicks() - timer > 1000)
 		{
 			timer += 1000;
 			printf("Frames: %d, Ticks: %d\n", frames, ticks);
+			printf("Allocations per frame: %.1f (%.0f bytes), max %llu\n", 
+				static_cast<double>(frame_allocations.allocations_) / frames, static_cast<double>(frame_allocations.bytes_) / frames, 
+				static_cast<unsigned long long>(max_frame_allocations));
+			input_latency_.Report();
+			audio_.Report();
 			frames = 0;
 			ticks = 0;
+			frame_allocations = { 0, 0 };
+			max_frame_allocations = 0;
+			AllowFrameAllocations();
+		}
+
+		const AllocationStats stats = frame_scope.Stats();
+		frame_allocations.allocations_ += stats.allocations_;
+		frame_allocations.bytes_ += stats.bytes_;
+		max_frame_allocations = std::max(max_frame_allocations, stats.allocations_);
+
+		if (total_frames > constants::allocation_warmup_frames && !frame_may_allocate_)
+		{
+			AllocationTracker::ExpectNone("frame", stats);
 		}
 	}
 }
@@ -209,6 +369,29 @@ GameMode Game::GameMode()
 	return game_mode_;
 }
 
+void Game::SetTickRate(double tick_rate)
+{
+	if (tick_rate > 0.0)
+	{
+		tick_rate_ = tick_rate;
+	}
+}
+
+int Game::SecondsToTicks(double seconds) const
+{
+	return std::max(1, static_cast<int>(std::lround(seconds * tick_rate_)));
+}
+
+void Game::SetMaxCatchUpTicks(int max_catch_up_ticks)
+{
+	max_catch_up_ticks_ = std::max(1, max_catch_up_ticks);
+}
+
+int Game::MaxCatchUpTicks() const
+{
+	return max_catch_up_ticks_;
+}
+
 void Game::HandleEvents()
 {
 	states_.top()->HandleEvents();		
@@ -216,10 +399,20 @@ void Game::HandleEvents()
 
 void Game::Tick()
 {
-	states_.top()->Tick();
+	GameState* state = states_.top();
+
+	if (!state->TicksOnMainThread())
+	{
+		state->Tick();
+		return;
+	}
+
+	const std::uint64_t tick_start = SDL_GetPerformanceCounter();
+	state->Tick();
+	Metrics::Instance().TickTime().Record((SDL_GetPerformanceCounter() - tick_start) * 1000000 / SDL_GetPerformanceFrequency());
 }
 
-void Game::Render()
+void Game::Render(double alpha)
 {	
-	states_.top()->Render();
+	states_.top()->Render(alpha);
 }
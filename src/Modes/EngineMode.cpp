@@ -0,0 +1,467 @@
+#include "Modes/EngineMode.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/Constants.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+	constexpr std::int64_t default_timeout_turn_ms = 5000;
+	constexpr std::int64_t move_overhead_ms = 30;
+	constexpr std::size_t default_n_symbols_to_win = 5;
+} // namespace
+
+EngineProtocol::EngineProtocol() : 
+	position_(3, 3, CellSymbol::X), 
+	running_(true), 
+	ponder_enabled_(false), 
+	pondering_(false), 
+	ponder_hit_(false), 
+	stop_requested_(false), 
+	quitting_(false), 
+	ponder_move_(-1), 
+	max_depth_(0), 
+	n_threads_(0), 
+	timeout_turn_ms_(default_timeout_turn_ms), 
+	time_left_ms_(0)
+{
+	search_ = std::make_unique<Search>(n_threads_);
+}
+
+EngineProtocol::~EngineProtocol()
+{
+	quitting_ = true;
+	StopSearch();
+}
+
+int EngineProtocol::Run(std::istream& in)
+{
+	std::string line;
+
+	while (running_ && std::getline(in, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+
+		std::istringstream line_stream(line);
+		std::string command;
+		line_stream >> command;
+		std::transform(command.begin(), command.end(), command.begin(), [](unsigned char c) { return std::toupper(c); });
+
+		std::string arguments;
+		std::getline(line_stream >> std::ws, arguments);
+
+		if (!command.empty())
+		{
+			HandleCommand(command, arguments, in);
+		}
+	}
+
+	quitting_ = true;
+	StopSearch();
+
+	return 0;
+}
+
+void EngineProtocol::HandleCommand(const std::string& command, const std::string& arguments, std::istream& in)
+{
+	if (command == "START")
+	{
+		std::istringstream argument_stream(arguments);
+		std::size_t dimension = 0;
+		std::size_t n_symbols_to_win = 0;
+		argument_stream >> dimension >> n_symbols_to_win;
+
+		if (dimension < 1 || dimension > constants::max_board_dimension)
+		{
+			Send("ERROR unsupported board size");
+			return;
+		}
+
+		if (n_symbols_to_win < 1 || n_symbols_to_win > dimension)
+		{
+			n_symbols_to_win = std::min(dimension, default_n_symbols_to_win);
+		}
+
+		StopSearch();
+		position_.Reset(dimension, n_symbols_to_win, CellSymbol::X);
+		search_->Clear();
+		Send("OK");
+	}
+	else if (command == "RESTART")
+	{
+		StopSearch();
+		position_.Reset(position_.Dimension(), position_.NSymbolsToWin(), CellSymbol::X);
+		search_->Clear();
+		Send("OK");
+	}
+	else if (command == "BEGIN")
+	{
+		StopSearch();
+		StartThinking();
+	}
+	else if (command == "TURN")
+	{
+		int index = -1;
+		bool valid = false;
+
+		{
+			// The search thread plays its own moves into position_ under the lock.
+			std::lock_guard<std::mutex> lock(mutex_);
+			valid = ParseMove(arguments, &index) && position_.At(index) == CellSymbol::EMPTY;
+		}
+
+		if (!valid)
+		{
+			Send("ERROR invalid move " + arguments);
+			return;
+		}
+
+		HandleTurn(index);
+	}
+	else if (command == "PONDERHIT")
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		const int predicted_move = ponder_move_;
+		const bool pondering = pondering_;
+		lock.unlock();
+
+		if (pondering)
+		{
+			HandleTurn(predicted_move);
+		}
+	}
+	else if (command == "BOARD")
+	{
+		StopSearch();
+		ReadBoard(in);
+		StartThinking();
+	}
+	else if (command == "INFO")
+	{
+		HandleInfo(arguments);
+	}
+	else if (command == "STOP")
+	{
+		StopSearch();
+	}
+	else if (command == "ABOUT")
+	{
+		Send("name=\"TicTacToe\", version=\"1.0\"");
+	}
+	else if (command == "END")
+	{
+		running_ = false;
+	}
+	else
+	{
+		Send("UNKNOWN " + command);
+	}
+}
+
+void EngineProtocol::HandleInfo(const std::string& arguments)
+{
+	std::istringstream argument_stream(arguments);
+	std::string key;
+	long long value = 0;
+
+	if (!(argument_stream >> key >> value))
+	{
+		return;
+	}
+
+	if (key == "timeout_turn")
+	{
+		timeout_turn_ms_ = value > 0 ? value : default_timeout_turn_ms;
+	}
+	else if (key == "time_left")
+	{
+		time_left_ms_ = value;
+	}
+	else if (key == "max_depth")
+	{
+		max_depth_ = static_cast<int>(value);
+	}
+	else if (key == "ponder")
+	{
+		ponder_enabled_ = value != 0;
+	}
+	else if (key == "threads" && value > 0)
+	{
+		StopSearch();
+		n_threads_ = static_cast<std::size_t>(value);
+		search_ = std::make_unique<Search>(n_threads_);
+	}
+}
+
+void EngineProtocol::HandleTurn(int index)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	if (pondering_ && !ponder_hit_ && index == ponder_move_)
+	{
+		position_.MakeMove(index);
+		ponder_hit_ = true;
+		search_->SetDeadline(std::chrono::steady_clock::now() + MoveBudget(position_));
+		lock.unlock();
+		ponder_condition_.notify_all();
+		return;
+	}
+
+	lock.unlock();
+	StopSearch();
+
+	// A search that was still running may have taken the cell before it stopped.
+	if (position_.At(index) != CellSymbol::EMPTY)
+	{
+		Send("ERROR invalid move");
+		return;
+	}
+
+	position_.MakeMove(index);
+	StartThinking();
+}
+
+void EngineProtocol::ReadBoard(std::istream& in)
+{
+	position_.Reset(position_.Dimension(), position_.NSymbolsToWin(), CellSymbol::X);
+
+	std::string line;
+
+	while (std::getline(in, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+
+		if (line == "DONE")
+		{
+			break;
+		}
+
+		int index = -1;
+		int who = 0;
+
+		if (ParseMove(line, &index, &who) && position_.At(index) == CellSymbol::EMPTY)
+		{
+			position_.Set(index, who == 1 ? CellSymbol::X : CellSymbol::O);
+		}
+	}
+}
+
+void EngineProtocol::StartThinking()
+{
+	if (search_thread_.joinable())
+	{
+		search_thread_.join();
+	}
+
+	if (position_.FreeCells() == 0 || position_.HasWinner())
+	{
+		Send("ERROR game is over");
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	stop_requested_ = false;
+	pondering_ = false;
+	ponder_hit_ = false;
+
+	search_thread_ = std::thread(&EngineProtocol::SearchLoop, this, position_, false);
+}
+
+void EngineProtocol::StopSearch()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_requested_ = true;
+		search_->Stop();
+		search_->SetDeadline(std::chrono::steady_clock::now());
+	}
+
+	ponder_condition_.notify_all();
+
+	if (search_thread_.joinable())
+	{
+		search_thread_.join();
+	}
+}
+
+void EngineProtocol::SearchLoop(Position position, bool ponder)
+{
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			// A STOP that lands before Run would be lost, since Run resets the stop flag. One that
+			// lands after this block still holds through the deadline StopSearch sets.
+			if (stop_requested_)
+			{
+				pondering_ = false;
+				return;
+			}
+
+			search_start_ = std::chrono::steady_clock::now();
+
+			if (!ponder)
+			{
+				search_->SetDeadline(search_start_ + MoveBudget(position));
+			}
+			else if (!ponder_hit_)
+			{
+				search_->ClearDeadline();
+			}
+
+			// Otherwise the ponderhit already came in and HandleTurn set the move's deadline.
+		}
+
+		const std::size_t board_dim = position.Dimension();
+		search_->SetIterationCallback([this, board_dim](const SearchResult& result) { SendInfo(result, board_dim); });
+
+		const int max_depth = max_depth_ > 0 ? max_depth_ : static_cast<int>(position.FreeCells());
+		const SearchResult result = search_->Run(position, max_depth);
+
+		std::unique_lock<std::mutex> lock(mutex_);
+
+		if (ponder)
+		{
+			ponder_condition_.wait(lock, [this]() { return ponder_hit_ || stop_requested_; });
+			pondering_ = false;
+
+			if (!ponder_hit_)
+			{
+				return;
+			}
+
+			ponder_hit_ = false;
+		}
+
+		if (quitting_ || result.best_move_ < 0)
+		{
+			return;
+		}
+
+		position_.MakeMove(result.best_move_);
+		Send(std::to_string(result.best_move_ % position_.Dimension()) + "," + std::to_string(result.best_move_ / position_.Dimension()));
+
+		if (!ponder_enabled_ || stop_requested_ || position_.IsWinningMove(result.best_move_) || position_.FreeCells() == 0)
+		{
+			return;
+		}
+
+		int predicted_move = search_->TableMove(position_);
+
+		for (std::size_t i = 0; predicted_move < 0 && i < position_.Cells(); ++i)
+		{
+			if (position_.At(i) == CellSymbol::EMPTY)
+			{
+				predicted_move = static_cast<int>(i);
+			}
+		}
+
+		position = position_;
+		position.MakeMove(predicted_move);
+
+		if (position.IsWinningMove(predicted_move) || position.FreeCells() == 0)
+		{
+			return;
+		}
+
+		ponder = true;
+		pondering_ = true;
+		ponder_move_ = predicted_move;
+	}
+}
+
+bool EngineProtocol::ParseMove(const std::string& text, int* index, int* who) const
+{
+	int x = -1;
+	int y = -1;
+	int player = 0;
+	char separator = 0;
+
+	std::istringstream move_stream(text);
+
+	if (!(move_stream >> x >> separator >> y) || separator != ',')
+	{
+		return false;
+	}
+
+	if (who != nullptr && !(move_stream >> separator >> player))
+	{
+		return false;
+	}
+
+	const int board_dim = static_cast<int>(position_.Dimension());
+
+	if (x < 0 || y < 0 || x >= board_dim || y >= board_dim)
+	{
+		return false;
+	}
+
+	*index = y * board_dim + x;
+
+	if (who != nullptr)
+	{
+		*who = player;
+	}
+
+	return true;
+}
+
+std::chrono::milliseconds EngineProtocol::MoveBudget(const Position& position) const
+{
+	std::int64_t budget = timeout_turn_ms_;
+
+	if (time_left_ms_ > 0)
+	{
+		const std::int64_t moves_left = static_cast<std::int64_t>(position.FreeCells() / 2 + 1);
+		budget = std::min(budget, time_left_ms_ / moves_left);
+	}
+
+	return std::chrono::milliseconds(std::max<std::int64_t>(1, budget - move_overhead_ms));
+}
+
+void EngineProtocol::Send(const std::string& line)
+{
+	std::lock_guard<std::mutex> lock(output_mutex_);
+	printf("%s\n", line.c_str());
+	fflush(stdout);
+}
+
+void EngineProtocol::SendInfo(const SearchResult& result, std::size_t board_dim)
+{
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - search_start_;
+	const double seconds = std::max(elapsed.count(), 1e-6);
+
+	char line[192];
+	snprintf(line, sizeof(line), "info depth %d score %d nodes %llu nps %llu time %lld pv %d,%d", 
+		result.depth_, result.score_, static_cast<unsigned long long>(result.nodes_), 
+		static_cast<unsigned long long>(result.nodes_ / seconds), static_cast<long long>(seconds * 1000), 
+		static_cast<int>(result.best_move_ % board_dim), static_cast<int>(result.best_move_ / board_dim));
+
+	Send(line);
+}
+
+int RunEngineMode()
+{
+	EngineProtocol engine;
+
+	return engine.Run(std::cin);
+}
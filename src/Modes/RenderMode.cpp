@@ -0,0 +1,318 @@
+#include "Modes/RenderMode.hpp"
+#include "AI/BoardEngine.hpp"
+#include "AI/Position.hpp"
+#include "Utils/AssetPack.hpp"
+#include "Utils/Constants.hpp"
+#include "BoardRenderer.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	enum class OutputFormat
+	{
+		PNG, RAW, NONE
+	};
+
+	struct RenderOptions
+	{
+		std::string output_dir_;
+		std::size_t n_threads_;
+		int width_;
+		int height_;
+		OutputFormat format_;
+		std::size_t repeat_;
+	};
+
+	bool ParseOptions(int argc, char* argv[], RenderOptions* options)
+	{
+		if (argc < 3)
+		{
+			return false;
+		}
+
+		options->output_dir_ = argv[2];
+		options->n_threads_ = std::max(1u, std::thread::hardware_concurrency());
+		options->width_ = constants::screen_width;
+		options->height_ = constants::screen_height;
+		options->format_ = OutputFormat::PNG;
+		options->repeat_ = 1;
+
+		for (int i = 3; i + 1 < argc; i += 2)
+		{
+			if (std::strcmp(argv[i], "--threads") == 0)
+			{
+				options->n_threads_ = std::strtoul(argv[i + 1], nullptr, 10);
+			}
+			else if (std::strcmp(argv[i], "--size") == 0)
+			{
+				if (std::sscanf(argv[i + 1], "%dx%d", &options->width_, &options->height_) != 2)
+				{
+					return false;
+				}
+			}
+			else if (std::strcmp(argv[i], "--format") == 0)
+			{
+				if (std::strcmp(argv[i + 1], "png") == 0)
+				{
+					options->format_ = OutputFormat::PNG;
+				}
+				else if (std::strcmp(argv[i + 1], "raw") == 0)
+				{
+					options->format_ = OutputFormat::RAW;
+				}
+				else if (std::strcmp(argv[i + 1], "none") == 0)
+				{
+					options->format_ = OutputFormat::NONE;
+				}
+				else
+				{
+					return false;
+				}
+			}
+			else if (std::strcmp(argv[i], "--repeat") == 0)
+			{
+				options->repeat_ = std::strtoul(argv[i + 1], nullptr, 10);
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options->n_threads_ > 0 && options->width_ > 0 && options->height_ > 0 && options->repeat_ > 0;
+	}
+
+	bool ParseBoard(const std::string& line, BoardSnapshot* snapshot)
+	{
+		char cells[10] = {};
+		int x_score = 0;
+		int o_score = 0;
+
+		if (std::sscanf(line.c_str(), "%9s %d %d", cells, &x_score, &o_score) < 1 || std::strlen(cells) != 9)
+		{
+			return false;
+		}
+
+		std::size_t n_x = 0;
+		std::size_t n_o = 0;
+
+		for (std::size_t i = 0; i < 9; ++i)
+		{
+			switch (cells[i])
+			{
+				case 'X': case 'x': snapshot->symbols_[i] = CellSymbol::X; ++n_x; break;
+				case 'O': case 'o': snapshot->symbols_[i] = CellSymbol::O; ++n_o; break;
+				case '.': case '-': snapshot->symbols_[i] = CellSymbol::EMPTY; break;
+				default: return false;
+			}
+
+			snapshot->render_win_[i] = false;
+			snapshot->symbol_fade_[i] = snapshot->symbol_fade_next_[i] = 1.0f;
+			snapshot->win_fade_[i] = snapshot->win_fade_next_[i] = 1.0f;
+		}
+
+		snapshot->win_ = false;
+		snapshot->player_turn_ = n_x <= n_o;
+		snapshot->analysis_ = false;
+		snapshot->analysis_generation_ = 0;
+
+		for (const board_engine::Line<3>& line_cells : BoardEngine<3, 3>::lines)
+		{
+			const CellSymbol symbol = snapshot->symbols_[line_cells[0]];
+
+			if (symbol != CellSymbol::EMPTY && symbol == snapshot->symbols_[line_cells[1]] && symbol == snapshot->symbols_[line_cells[2]])
+			{
+				for (std::size_t index : line_cells)
+				{
+					snapshot->render_win_[index] = true;
+				}
+
+				snapshot->win_ = true;
+				snapshot->player_turn_ = symbol == CellSymbol::X;
+			}
+		}
+
+		snapshot->transition_ = snapshot->transition_next_ = 1.0f;
+		snapshot->free_cells_ = 9 - n_x - n_o;
+		snapshot->x_score_ = x_score;
+		snapshot->o_score_ = o_score;
+
+		return true;
+	}
+
+	bool WriteRaw(const char* path, SDL_Surface* surface)
+	{
+		FILE* file = std::fopen(path, "wb");
+
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		bool written = true;
+
+		for (int y = 0; y < surface->h && written; ++y)
+		{
+			const char* row = static_cast<const char*>(surface->pixels) + y * surface->pitch;
+			written = std::fwrite(row, 4, surface->w, file) == static_cast<std::size_t>(surface->w);
+		}
+
+		return std::fclose(file) == 0 && written;
+	}
+
+	// One worker per thread, each with its own surface, software renderer and BoardRenderer, so
+	// nothing but the job counter is shared.
+	void RenderWorker(const RenderOptions& options, const std::vector<BoardSnapshot>& boards, std::atomic<std::size_t>* next_job, std::atomic<std::size_t>* failures)
+	{
+		SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, options.width_, options.height_, 32, SDL_PIXELFORMAT_RGBA32);
+		SDL_Renderer* renderer = surface != nullptr ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+
+		if (renderer == nullptr)
+		{
+			printf("Software renderer could not be created! SDL Error: %s\n", SDL_GetError());
+			SDL_FreeSurface(surface);
+			failures->fetch_add(1);
+			return;
+		}
+
+		{
+			BoardRenderer board_renderer;
+			const double ui_scale = std::min(static_cast<double>(options.width_) / constants::screen_width, static_cast<double>(options.height_) / constants::screen_height);
+
+			if (board_renderer.Initialize(renderer) && board_renderer.Layout(options.width_, options.height_, ui_scale, 0, 0))
+			{
+				const std::size_t n_jobs = boards.size() * options.repeat_;
+				char path[4096];
+
+				for (std::size_t job = next_job->fetch_add(1); job < n_jobs; job = next_job->fetch_add(1))
+				{
+					board_renderer.Render(boards[job % boards.size()], 0.0f, false);
+					SDL_RenderPresent(renderer);
+
+					bool written = true;
+
+					if (options.format_ == OutputFormat::PNG)
+					{
+						std::snprintf(path, sizeof(path), "%s/board_%06zu.png", options.output_dir_.c_str(), job);
+						written = IMG_SavePNG(surface, path) == 0;
+					}
+					else if (options.format_ == OutputFormat::RAW)
+					{
+						std::snprintf(path, sizeof(path), "%s/board_%06zu.rgba", options.output_dir_.c_str(), job);
+						written = WriteRaw(path, surface);
+					}
+
+					if (!written)
+					{
+						printf("Failed to write %s!\n", path);
+						failures->fetch_add(1);
+					}
+				}
+			}
+			else
+			{
+				failures->fetch_add(1);
+			}
+		}
+
+		SDL_DestroyRenderer(renderer);
+		SDL_FreeSurface(surface);
+	}
+} // namespace
+
+int RunRenderMode(int argc, char* argv[])
+{
+	RenderOptions options;
+
+	if (!ParseOptions(argc, argv, &options))
+	{
+		printf("Usage: %s --render <out_dir> [--threads N] [--size WxH] [--format png|raw|none] [--repeat N]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<BoardSnapshot> boards;
+	std::string line;
+
+	while (std::getline(std::cin, line))
+	{
+		BoardSnapshot snapshot;
+
+		if (ParseBoard(line, &snapshot))
+		{
+			boards.push_back(snapshot);
+		}
+		else if (!line.empty())
+		{
+			printf("Skipping malformed board: %s\n", line.c_str());
+		}
+	}
+
+	if (boards.empty())
+	{
+		printf("No boards to render!\n");
+		return 1;
+	}
+
+	// No window is ever created, so the dummy driver lets this run without a display.
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0)
+	{
+		printf("SDL could not be initialized! SDL Error: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	constexpr int img_flags = IMG_INIT_PNG;
+
+	if (!(IMG_Init(img_flags) & img_flags) || TTF_Init() == -1)
+	{
+		printf("SDL_image or SDL_ttf could not be initialized!\n");
+		SDL_Quit();
+		return 1;
+	}
+
+	AssetPack::Instance().Mount();
+
+	std::atomic<std::size_t> next_job(0);
+	std::atomic<std::size_t> failures(0);
+	std::vector<std::thread> workers;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < options.n_threads_; ++i)
+	{
+		workers.emplace_back(RenderWorker, std::cref(options), std::cref(boards), &next_job, &failures);
+	}
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const std::size_t n_rendered = boards.size() * options.repeat_;
+
+	printf("Rendered %zu boards at %dx%d on %zu threads in %.3f s (%.0f boards/s)\n", 
+		n_rendered, options.width_, options.height_, options.n_threads_, seconds, n_rendered / std::max(seconds, 1e-9));
+
+	TTF_Quit();
+	IMG_Quit();
+	SDL_Quit();
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+#include "Modes/ServerMode.hpp"
+#include "AI/Position.hpp"
+#include "Server/GameServer.hpp"
+#include "Server/Protocol.hpp"
+#include "Utils/LatencyHistogram.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	constexpr std::uint16_t default_port = 7777;
+
+	unsigned long Argument(int argc, char* argv[], int index, unsigned long fallback)
+	{
+		return argc > index ? std::strtoul(argv[index], nullptr, 10) : fallback;
+	}
+
+	struct ClientSession
+	{
+		Position position_;
+		std::chrono::steady_clock::time_point sent_;
+	};
+
+	class LoadConnection
+	{
+	private:
+		int fd_;
+		std::size_t dimension_;
+		std::size_t n_symbols_to_win_;
+		std::mt19937 random_;
+		std::unordered_map<std::uint32_t, ClientSession> sessions_;
+		std::string output_;
+
+		void SendNew()
+		{
+			char frame[protocol::FrameSize(static_cast<std::uint8_t>(protocol::Opcode::NEW))];
+			protocol::Write<std::uint8_t>(frame, static_cast<std::uint8_t>(protocol::Opcode::NEW));
+			protocol::Write<std::uint8_t>(frame + 1, static_cast<std::uint8_t>(dimension_));
+			protocol::Write<std::uint8_t>(frame + 2, static_cast<std::uint8_t>(n_symbols_to_win_));
+			protocol::Write<std::uint8_t>(frame + 3, 0);
+			output_.append(frame, sizeof(frame));
+		}
+
+		void SendRandomMove(std::uint32_t session_id, ClientSession& session)
+		{
+			std::uniform_int_distribution<std::size_t> pick(0, session.position_.FreeCells() - 1);
+			std::size_t skip = pick(random_);
+			std::size_t cell = 0;
+
+			for (; cell < session.position_.Cells(); ++cell)
+			{
+				if (session.position_.At(cell) == CellSymbol::EMPTY && skip-- == 0)
+				{
+					break;
+				}
+			}
+
+			session.position_.MakeMove(cell);
+			session.sent_ = std::chrono::steady_clock::now();
+
+			char frame[protocol::FrameSize(static_cast<std::uint8_t>(protocol::Opcode::MOVE))];
+			protocol::Write<std::uint8_t>(frame, static_cast<std::uint8_t>(protocol::Opcode::MOVE));
+			protocol::Write<std::uint32_t>(frame + 1, session_id);
+			protocol::Write<std::uint16_t>(frame + 5, static_cast<std::uint16_t>(cell));
+			output_.append(frame, sizeof(frame));
+		}
+
+		void SendClose(std::uint32_t session_id)
+		{
+			char frame[protocol::FrameSize(static_cast<std::uint8_t>(protocol::Opcode::CLOSE))];
+			protocol::Write<std::uint8_t>(frame, static_cast<std::uint8_t>(protocol::Opcode::CLOSE));
+			protocol::Write<std::uint32_t>(frame + 1, session_id);
+			output_.append(frame, sizeof(frame));
+		}
+
+		bool Flush()
+		{
+			std::size_t offset = 0;
+
+			while (offset < output_.size())
+			{
+				const ssize_t n_written = send(fd_, output_.data() + offset, output_.size() - offset, MSG_NOSIGNAL);
+
+				if (n_written <= 0)
+				{
+					return false;
+				}
+
+				offset += static_cast<std::size_t>(n_written);
+			}
+
+			output_.clear();
+			return true;
+		}
+
+		void HandleFrame(const char* frame, LatencyHistogram* latency_us, std::uint64_t* moves)
+		{
+			const std::uint32_t session_id = protocol::Read<std::uint32_t>(frame + 1);
+
+			switch (static_cast<protocol::Opcode>(frame[0]))
+			{
+				case protocol::Opcode::SESSION:
+				{
+					ClientSession& session = sessions_[session_id];
+					session.position_.Reset(dimension_, n_symbols_to_win_, CellSymbol::X);
+					SendRandomMove(session_id, session);
+					break;
+				}
+
+				case protocol::Opcode::MOVE_RESULT:
+				{
+					ClientSession& session = sessions_[session_id];
+					const std::uint16_t cell = protocol::Read<std::uint16_t>(frame + 5);
+					const auto status = static_cast<protocol::Status>(frame[7]);
+
+					latency_us->Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - session.sent_).count());
+					++*moves;
+
+					if (cell != protocol::no_cell)
+					{
+						session.position_.MakeMove(cell);
+					}
+
+					if (status == protocol::Status::ONGOING)
+					{
+						SendRandomMove(session_id, session);
+					}
+					else
+					{
+						sessions_.erase(session_id);
+						SendClose(session_id);
+						SendNew();
+					}
+
+					break;
+				}
+
+				default:
+					printf("Server reported error %u for session %u\n", static_cast<unsigned>(static_cast<std::uint8_t>(frame[5])), session_id);
+					break;
+			}
+		}
+
+	public:
+		LoadConnection(std::size_t dimension, std::size_t n_symbols_to_win, unsigned seed) : 
+			fd_(-1), 
+			dimension_(dimension), 
+			n_symbols_to_win_(n_symbols_to_win), 
+			random_(seed)
+		{
+		}
+
+		~LoadConnection()
+		{
+			if (fd_ != -1)
+			{
+				close(fd_);
+			}
+		}
+
+		bool Connect(std::uint16_t port)
+		{
+			fd_ = socket(AF_INET, SOCK_STREAM, 0);
+
+			const int enable = 1;
+			setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+			sockaddr_in address = {};
+			address.sin_family = AF_INET;
+			address.sin_port = htons(port);
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+			return connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+		}
+
+		void Play(std::size_t n_sessions, std::chrono::steady_clock::time_point end, LatencyHistogram* latency_us, std::uint64_t* moves)
+		{
+			for (std::size_t i = 0; i < n_sessions; ++i)
+			{
+				SendNew();
+			}
+
+			std::string input;
+			char buffer[16 * 1024];
+
+			while (std::chrono::steady_clock::now() < end && Flush())
+			{
+				const ssize_t n_read = recv(fd_, buffer, sizeof(buffer), 0);
+
+				if (n_read <= 0)
+				{
+					return;
+				}
+
+				input.append(buffer, static_cast<std::size_t>(n_read));
+
+				std::size_t offset = 0;
+
+				while (offset < input.size())
+				{
+					const std::size_t frame_size = protocol::FrameSize(static_cast<std::uint8_t>(input[offset]));
+
+					if (frame_size == 0 || offset + frame_size > input.size())
+					{
+						break;
+					}
+
+					HandleFrame(input.data() + offset, latency_us, moves);
+					offset += frame_size;
+				}
+
+				input.erase(0, offset);
+			}
+		}
+	};
+} // namespace
+
+int RunServerMode(int argc, char* argv[])
+{
+	const std::uint16_t port = static_cast<std::uint16_t>(Argument(argc, argv, 2, default_port));
+	const std::size_t n_workers = Argument(argc, argv, 3, 0);
+
+	GameServer server(n_workers);
+
+	if (!server.Listen(port))
+	{
+		return 1;
+	}
+
+	server.Run();
+
+	return 0;
+}
+
+int RunLoadClientMode(int argc, char* argv[])
+{
+	const std::uint16_t port = static_cast<std::uint16_t>(Argument(argc, argv, 2, default_port));
+	const std::size_t n_connections = Argument(argc, argv, 3, 8);
+	const std::size_t sessions_per_connection = Argument(argc, argv, 4, 128);
+	const std::size_t seconds = Argument(argc, argv, 5, 10);
+	const std::size_t dimension = Argument(argc, argv, 6, 3);
+	const std::size_t n_symbols_to_win = Argument(argc, argv, 7, dimension);
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto end = start + std::chrono::seconds(seconds);
+
+	std::mutex results_mutex;
+	LatencyHistogram latency_us;
+	std::uint64_t moves = 0;
+
+	std::vector<std::thread> threads;
+
+	for (std::size_t i = 0; i < n_connections; ++i)
+	{
+		threads.emplace_back([&, i]()
+		{
+			LoadConnection connection(dimension, n_symbols_to_win, static_cast<unsigned>(i + 1));
+			LatencyHistogram local_latency_us;
+			std::uint64_t local_moves = 0;
+
+			if (!connection.Connect(port))
+			{
+				printf("Connection %zu failed to connect to port %u\n", i, port);
+				return;
+			}
+
+			connection.Play(sessions_per_connection, end, &local_latency_us, &local_moves);
+
+			std::lock_guard<std::mutex> lock(results_mutex);
+			latency_us.Merge(local_latency_us);
+			moves += local_moves;
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	printf("Boards: %zu, Moves: %llu, Throughput: %.0f moves/s, Round trip us p50: %llu p99: %llu p99.9: %llu max: %llu\n", 
+		n_connections * sessions_per_connection, static_cast<unsigned long long>(moves), moves / elapsed.count(), 
+		static_cast<unsigned long long>(latency_us.Percentile(50.0)), static_cast<unsigned long long>(latency_us.Percentile(99.0)), 
+		static_cast<unsigned long long>(latency_us.Percentile(99.9)), static_cast<unsigned long long>(latency_us.Max()));
+
+	return 0;
+}
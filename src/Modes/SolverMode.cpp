@@ -0,0 +1,158 @@
+#include "Modes/SolverMode.hpp"
+#include "AI/Position.hpp"
+#include "AI/ProofNumberSearch.hpp"
+#include "Utils/Constants.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace
+{
+	struct SolverOptions
+	{
+		std::size_t dimension_;
+		std::size_t n_symbols_to_win_;
+		CellSymbol first_;
+		std::size_t memory_mb_;
+		std::string checkpoint_path_;
+		std::uint64_t checkpoint_interval_;
+		std::string proof_path_;
+	};
+
+	bool ParseOptions(int argc, char* argv[], SolverOptions* options)
+	{
+		if (argc < 4)
+		{
+			return false;
+		}
+
+		options->dimension_ = std::strtoul(argv[2], nullptr, 10);
+		options->n_symbols_to_win_ = std::strtoul(argv[3], nullptr, 10);
+		options->first_ = CellSymbol::X;
+		options->memory_mb_ = 256;
+		options->checkpoint_interval_ = 10'000'000;
+
+		for (int i = 4; i + 1 < argc; i += 2)
+		{
+			if (std::strcmp(argv[i], "--first") == 0)
+			{
+				options->first_ = argv[i + 1][0] == 'O' ? CellSymbol::O : CellSymbol::X;
+			}
+			else if (std::strcmp(argv[i], "--memory") == 0)
+			{
+				options->memory_mb_ = std::strtoul(argv[i + 1], nullptr, 10);
+			}
+			else if (std::strcmp(argv[i], "--checkpoint") == 0)
+			{
+				options->checkpoint_path_ = argv[i + 1];
+			}
+			else if (std::strcmp(argv[i], "--interval") == 0)
+			{
+				options->checkpoint_interval_ = std::strtoull(argv[i + 1], nullptr, 10);
+			}
+			else if (std::strcmp(argv[i], "--proof") == 0)
+			{
+				options->proof_path_ = argv[i + 1];
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options->dimension_ >= 1 && options->dimension_ <= constants::max_board_dimension && 
+			options->n_symbols_to_win_ >= 1 && options->n_symbols_to_win_ <= options->dimension_ && 
+			options->memory_mb_ > 0;
+	}
+
+	std::unique_ptr<ProofNumberSearch> SolveFor(CellSymbol attacker, const Position& root, const SolverOptions& options, bool* proven)
+	{
+		std::unique_ptr<ProofNumberSearch> search = std::make_unique<ProofNumberSearch>(attacker, options.memory_mb_ * 1024 * 1024);
+
+		if (!options.checkpoint_path_.empty())
+		{
+			search->SetCheckpoint(options.checkpoint_path_ + (attacker == CellSymbol::X ? ".X" : ".O"), options.checkpoint_interval_);
+
+			if (search->LoadCheckpoint(root))
+			{
+				printf("Resumed %c solve from checkpoint at %llu nodes\n", attacker == CellSymbol::X ? 'X' : 'O', static_cast<unsigned long long>(search->Nodes()));
+			}
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		*proven = search->Solve(root);
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		printf("%c can force a win: %s (%llu nodes, %.2f s)\n", attacker == CellSymbol::X ? 'X' : 'O', *proven ? "yes" : "no", 
+			static_cast<unsigned long long>(search->Nodes()), elapsed.count());
+
+		return search;
+	}
+} // namespace
+
+int RunSolverMode(int argc, char* argv[])
+{
+	SolverOptions options;
+
+	if (!ParseOptions(argc, argv, &options))
+	{
+		printf("Usage: %s --solve <dimension> <n_symbols_to_win> [--first X|O] [--memory MB] [--checkpoint PATH] [--interval NODES] [--proof PATH]\n", argv[0]);
+		return 1;
+	}
+
+	const Position root(options.dimension_, options.n_symbols_to_win_, options.first_);
+	const CellSymbol second = Position::Opponent(options.first_);
+
+	std::ofstream proof_file;
+	std::ostream* proof_out = nullptr;
+
+	if (!options.proof_path_.empty())
+	{
+		proof_file.open(options.proof_path_, std::ios::trunc);
+		proof_out = proof_file ? &proof_file : nullptr;
+
+		if (proof_out == nullptr)
+		{
+			printf("Failed to open proof file %s!\n", options.proof_path_.c_str());
+		}
+	}
+
+	bool first_wins = false;
+	std::unique_ptr<ProofNumberSearch> first_search = SolveFor(options.first_, root, options, &first_wins);
+
+	if (first_wins)
+	{
+		printf("Result: %zux%zu k=%zu is a first-player (%c) win\n", options.dimension_, options.dimension_, options.n_symbols_to_win_, options.first_ == CellSymbol::X ? 'X' : 'O');
+
+		if (proof_out != nullptr)
+		{
+			first_search->WriteProofTree(root, *proof_out);
+		}
+
+		return 0;
+	}
+
+	bool second_wins = false;
+	std::unique_ptr<ProofNumberSearch> second_search = SolveFor(second, root, options, &second_wins);
+
+	printf("Result: %zux%zu k=%zu is a %s\n", options.dimension_, options.dimension_, options.n_symbols_to_win_, second_wins ? "second-player win" : "draw");
+
+	if (proof_out != nullptr)
+	{
+		if (!second_wins)
+		{
+			first_search->WriteProofTree(root, *proof_out);
+		}
+
+		second_search->WriteProofTree(root, *proof_out);
+	}
+
+	return 0;
+}
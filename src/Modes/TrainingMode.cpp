@@ -0,0 +1,213 @@
+#include "Modes/TrainingMode.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/AssetPack.hpp"
+#include "Utils/Constants.hpp"
+#include "BoardRenderer.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct Variant
+	{
+		std::size_t dimension_;
+		std::size_t n_symbols_to_win_;
+		int depth_;
+		std::size_t n_opening_moves_;
+	};
+
+	// Small boards searched to the end plus larger ones at a fixed depth, so both the mate-score
+	// paths and the heuristic cut-offs show up in the profile.
+	constexpr Variant variants[] = {
+		{ 3, 3, 9, 0 },
+		{ 4, 3, 7, 2 },
+		{ 4, 4, 7, 2 },
+		{ 5, 4, 5, 4 },
+		{ 7, 5, 4, 6 },
+	};
+
+	Position RandomPosition(const Variant& variant, std::mt19937& random)
+	{
+		Position position(variant.dimension_, variant.n_symbols_to_win_, CellSymbol::X);
+
+		for (std::size_t i = 0; i < variant.n_opening_moves_; ++i)
+		{
+			std::size_t index = random() % position.Cells();
+
+			while (position.At(index) != CellSymbol::EMPTY)
+			{
+				index = (index + 1) % position.Cells();
+			}
+
+			position.MakeMove(index);
+
+			if (position.IsWinningMove(index))
+			{
+				position.UnmakeMove(index);
+			}
+		}
+
+		return position;
+	}
+
+	std::uint64_t TrainSearch(std::size_t rounds, std::mt19937& random)
+	{
+		// One thread and a cleared table per position keep node counts reproducible.
+		Search search(1);
+		std::uint64_t checksum = 0;
+
+		for (std::size_t round = 0; round < rounds; ++round)
+		{
+			for (const Variant& variant : variants)
+			{
+				search.Clear();
+
+				const SearchResult result = search.Run(RandomPosition(variant, random), variant.depth_);
+				checksum = checksum * 31 + result.nodes_ + static_cast<std::uint64_t>(result.best_move_) + static_cast<std::uint64_t>(result.score_);
+			}
+		}
+
+		return checksum;
+	}
+
+	std::uint64_t TrainWinDetection(std::size_t rounds, std::mt19937& random)
+	{
+		std::uint64_t checksum = 0;
+
+		for (std::size_t round = 0; round < rounds * 2000; ++round)
+		{
+			const Variant& variant = variants[round % (sizeof(variants) / sizeof(variants[0]))];
+			Position position(variant.dimension_, variant.n_symbols_to_win_, CellSymbol::X);
+
+			while (position.FreeCells() != 0)
+			{
+				std::size_t index = random() % position.Cells();
+
+				while (position.At(index) != CellSymbol::EMPTY)
+				{
+					index = (index + 1) % position.Cells();
+				}
+
+				position.MakeMove(index);
+
+				if (position.IsWinningMove(index))
+				{
+					break;
+				}
+			}
+
+			CellSymbol winner = CellSymbol::EMPTY;
+			checksum += position.HasWinner(&winner) ? static_cast<std::uint64_t>(winner) : 3;
+		}
+
+		return checksum;
+	}
+
+	std::uint64_t TrainRender(std::size_t rounds, std::mt19937& random)
+	{
+		SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, constants::screen_width, constants::screen_height, 32, SDL_PIXELFORMAT_RGBA32);
+		SDL_Renderer* renderer = surface != nullptr ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+
+		if (renderer == nullptr)
+		{
+			printf("Software renderer could not be created! SDL Error: %s\n", SDL_GetError());
+			SDL_FreeSurface(surface);
+			return 0;
+		}
+
+		std::uint64_t checksum = 0;
+
+		{
+			BoardRenderer board_renderer;
+
+			if (board_renderer.Initialize(renderer) && board_renderer.Layout(constants::screen_width, constants::screen_height, 1.0, 0, 0))
+			{
+				BoardSnapshot snapshot = {};
+
+				for (std::size_t frame = 0; frame < rounds * 50; ++frame)
+				{
+					for (std::size_t i = 0; i < snapshot.symbols_.size(); ++i)
+					{
+						snapshot.symbols_[i] = static_cast<CellSymbol>(random() % 3);
+						snapshot.render_win_[i] = random() % 4 == 0;
+						snapshot.symbol_fade_[i] = snapshot.symbol_fade_next_[i] = 1.0f;
+						snapshot.win_fade_[i] = snapshot.win_fade_next_[i] = 1.0f;
+					}
+
+					snapshot.free_cells_ = random() % 10;
+					snapshot.win_ = random() % 2 == 0;
+					snapshot.player_turn_ = random() % 2 == 0;
+					snapshot.x_score_ = static_cast<int>(frame / 10);
+
+					board_renderer.Render(snapshot, static_cast<float>(frame % 8) / 8.0f, false);
+					SDL_RenderPresent(renderer);
+
+					checksum += static_cast<const Uint8*>(surface->pixels)[(frame * 4099) % (surface->h * surface->pitch)];
+				}
+			}
+		}
+
+		SDL_DestroyRenderer(renderer);
+		SDL_FreeSurface(surface);
+
+		return checksum;
+	}
+
+	template <typename Phase>
+	std::uint64_t TimePhase(const char* name, Phase phase, double* total_ms)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const std::uint64_t checksum = phase();
+		const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		printf("%-15s %10.1f ms  checksum %016llx\n", name, elapsed, static_cast<unsigned long long>(checksum));
+		*total_ms += elapsed;
+
+		return checksum;
+	}
+} // namespace
+
+int RunTrainingMode(int argc, char* argv[])
+{
+	const std::size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+	constexpr int img_flags = IMG_INIT_PNG;
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0 || !(IMG_Init(img_flags) & img_flags) || TTF_Init() == -1)
+	{
+		printf("SDL could not be initialized! SDL Error: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	AssetPack::Instance().Mount();
+
+	// Every phase gets its own fixed seed so the workload does not depend on phase order.
+	std::mt19937 search_random(1);
+	std::mt19937 win_random(2);
+	std::mt19937 render_random(3);
+	double total_ms = 0.0;
+
+	TimePhase("search", [&]() { return TrainSearch(rounds, search_random); }, &total_ms);
+	TimePhase("win detection", [&]() { return TrainWinDetection(rounds, win_random); }, &total_ms);
+	TimePhase("render", [&]() { return TrainRender(rounds, render_random); }, &total_ms);
+
+	printf("%-15s %10.1f ms\n", "total", total_ms);
+
+	TTF_Quit();
+	IMG_Quit();
+	SDL_Quit();
+
+	return 0;
+}
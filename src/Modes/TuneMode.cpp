@@ -0,0 +1,423 @@
+#include "Modes/TuneMode.hpp"
+#include "AI/Evaluator.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct TuneOptions
+	{
+		std::size_t games_;
+		int depth_;
+		std::string load_path_;
+		std::string save_path_;
+		std::size_t epochs_;
+		double rate_;
+		std::string output_path_;
+	};
+
+	struct Sample
+	{
+		evaluation::FeatureVector features_;
+		float result_;
+	};
+
+	struct Variant
+	{
+		std::size_t dimension_;
+		std::size_t n_symbols_to_win_;
+	};
+
+	constexpr Variant variants[] = { { 3, 3 }, { 4, 3 }, { 4, 4 }, { 5, 4 }, { 6, 4 }, { 7, 5 }, { 9, 5 } };
+
+	constexpr char samples_magic[4] = { 'T', 'X', 'S', '1' };
+
+	bool ParseOptions(int argc, char* argv[], TuneOptions* options)
+	{
+		options->games_ = 20000;
+		options->depth_ = 2;
+		options->epochs_ = 500;
+		options->rate_ = 0.05;
+		options->output_path_ = "weights.bin";
+
+		for (int i = 2; i + 1 < argc; i += 2)
+		{
+			if (std::strcmp(argv[i], "--games") == 0)
+			{
+				options->games_ = std::strtoul(argv[i + 1], nullptr, 10);
+			}
+			else if (std::strcmp(argv[i], "--depth") == 0)
+			{
+				options->depth_ = std::atoi(argv[i + 1]);
+			}
+			else if (std::strcmp(argv[i], "--load") == 0)
+			{
+				options->load_path_ = argv[i + 1];
+			}
+			else if (std::strcmp(argv[i], "--save") == 0)
+			{
+				options->save_path_ = argv[i + 1];
+			}
+			else if (std::strcmp(argv[i], "--epochs") == 0)
+			{
+				options->epochs_ = std::strtoul(argv[i + 1], nullptr, 10);
+			}
+			else if (std::strcmp(argv[i], "--rate") == 0)
+			{
+				options->rate_ = std::strtod(argv[i + 1], nullptr);
+			}
+			else if (std::strcmp(argv[i], "--output") == 0)
+			{
+				options->output_path_ = argv[i + 1];
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options->depth_ >= 1 && options->rate_ > 0.0;
+	}
+
+	// Runs job(worker, slice, begin, end) over [0, n) split into one slice per pool worker and waits.
+	void ParallelFor(ThreadPool& pool, std::size_t n, const std::function<void(std::size_t, std::size_t, std::size_t, std::size_t)>& job)
+	{
+		const std::size_t n_slices = pool.Workers();
+		std::mutex mutex;
+		std::condition_variable done;
+		std::size_t remaining = n_slices;
+
+		for (std::size_t slice = 0; slice < n_slices; ++slice)
+		{
+			pool.Submit([&, slice](std::size_t worker_index)
+			{
+				job(worker_index, slice, n * slice / n_slices, n * (slice + 1) / n_slices);
+
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if (--remaining == 0)
+				{
+					done.notify_one();
+				}
+			});
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [&]() { return remaining == 0; });
+	}
+
+	// Plays one game with a little randomness so positions do not repeat, and labels every
+	// position with the final result from its side to move's point of view.
+	void PlaySelfPlayGame(std::size_t game_index, int depth, Search& search, std::vector<Sample>* samples)
+	{
+		std::mt19937 random(static_cast<std::uint32_t>(game_index * 2654435761u + 1));
+		const Variant& variant = variants[game_index % (sizeof(variants) / sizeof(variants[0]))];
+
+		Position position(variant.dimension_, variant.n_symbols_to_win_, CellSymbol::X);
+		std::vector<std::pair<evaluation::FeatureVector, CellSymbol>> history;
+		CellSymbol winner = CellSymbol::EMPTY;
+
+		const std::size_t n_random_moves = random() % 3;
+		search.Clear();
+
+		while (position.FreeCells() != 0)
+		{
+			evaluation::FeatureVector features;
+			Evaluator::Features(position, &features);
+			history.emplace_back(features, position.SideToMove());
+
+			int move = -1;
+
+			if (history.size() <= n_random_moves || random() % 10 == 0)
+			{
+				move = static_cast<int>(random() % position.Cells());
+
+				while (position.At(move) != CellSymbol::EMPTY)
+				{
+					move = (move + 1) % static_cast<int>(position.Cells());
+				}
+			}
+			else
+			{
+				move = search.Run(position, depth).best_move_;
+			}
+
+			position.MakeMove(move);
+
+			if (position.IsWinningMove(move))
+			{
+				winner = position.At(move);
+				break;
+			}
+		}
+
+		for (const auto& [features, side_to_move] : history)
+		{
+			const float result = winner == CellSymbol::EMPTY ? 0.5f : (winner == side_to_move ? 1.0f : 0.0f);
+			samples->push_back({ features, result });
+		}
+	}
+
+	bool LoadSamples(const std::string& path, std::vector<Sample>* samples)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		char magic[4];
+		std::uint64_t n_samples = 0;
+
+		if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, samples_magic, sizeof(magic)) != 0 || 
+			!file.read(reinterpret_cast<char*>(&n_samples), sizeof(n_samples)))
+		{
+			return false;
+		}
+
+		const std::size_t offset = samples->size();
+		samples->resize(offset + n_samples);
+
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(samples->data() + offset), n_samples * sizeof(Sample)));
+	}
+
+	bool SaveSamples(const std::string& path, const std::vector<Sample>& samples)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		const std::uint64_t n_samples = samples.size();
+
+		file.write(samples_magic, sizeof(samples_magic));
+		file.write(reinterpret_cast<const char*>(&n_samples), sizeof(n_samples));
+		file.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(Sample));
+
+		return static_cast<bool>(file);
+	}
+
+	double Sigmoid(double x)
+	{
+		return 1.0 / (1.0 + std::exp(-x));
+	}
+
+	double Dot(const std::array<double, evaluation::N_FEATURES>& weights, const evaluation::FeatureVector& features)
+	{
+		double score = 0.0;
+
+		for (std::size_t i = 0; i < evaluation::N_FEATURES; ++i)
+		{
+			score += weights[i] * features[i];
+		}
+
+		return score;
+	}
+
+	// Mean squared error between results and sigmoid(scale * score / 400), the Texel objective.
+	// With a gradient buffer it also accumulates d(error)/d(weight) for one batch.
+	double Error(ThreadPool& pool, const std::vector<Sample>& samples, const std::array<double, evaluation::N_FEATURES>& weights, double scale, 
+		std::array<double, evaluation::N_FEATURES>* gradient)
+	{
+		struct Partial
+		{
+			double error_;
+			std::array<double, evaluation::N_FEATURES> gradient_;
+		};
+
+		std::vector<Partial> partials(pool.Workers(), Partial { 0.0, {} });
+
+		ParallelFor(pool, samples.size(), [&](std::size_t, std::size_t slice, std::size_t begin, std::size_t end)
+		{
+			Partial partial = { 0.0, {} };
+
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				const double prediction = Sigmoid(scale * Dot(weights, samples[i].features_) / 400.0);
+				const double difference = samples[i].result_ - prediction;
+
+				partial.error_ += difference * difference;
+
+				if (gradient != nullptr)
+				{
+					const double factor = -2.0 * difference * prediction * (1.0 - prediction) * scale / 400.0;
+
+					for (std::size_t f = 0; f < evaluation::N_FEATURES; ++f)
+					{
+						partial.gradient_[f] += factor * samples[i].features_[f];
+					}
+				}
+			}
+
+			partials[slice] = partial;
+		});
+
+		double error = 0.0;
+
+		if (gradient != nullptr)
+		{
+			gradient->fill(0.0);
+		}
+
+		for (const Partial& partial : partials)
+		{
+			error += partial.error_;
+
+			for (std::size_t f = 0; gradient != nullptr && f < evaluation::N_FEATURES; ++f)
+			{
+				(*gradient)[f] += partial.gradient_[f] / samples.size();
+			}
+		}
+
+		return error / samples.size();
+	}
+} // namespace
+
+int RunTuneMode(int argc, char* argv[])
+{
+	TuneOptions options;
+
+	if (!ParseOptions(argc, argv, &options))
+	{
+		printf("Usage: %s --tune [--games N] [--depth D] [--load PATH] [--save PATH] [--epochs N] [--rate R] [--output PATH]\n", argv[0]);
+		return 1;
+	}
+
+	ThreadPool pool;
+	std::vector<Sample> samples;
+
+	if (!options.load_path_.empty() && !LoadSamples(options.load_path_, &samples))
+	{
+		printf("Failed to load positions from %s!\n", options.load_path_.c_str());
+		return 1;
+	}
+
+	if (options.games_ > 0)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		// One single-threaded Search and sample buffer per worker; buffers are merged afterwards.
+		std::vector<std::unique_ptr<Search>> searches;
+		std::vector<std::vector<Sample>> worker_samples(pool.Workers());
+
+		for (std::size_t i = 0; i < pool.Workers(); ++i)
+		{
+			searches.push_back(std::make_unique<Search>(1, 1 << 14));
+		}
+
+		ParallelFor(pool, options.games_, [&](std::size_t worker_index, std::size_t, std::size_t begin, std::size_t end)
+		{
+			for (std::size_t game = begin; game < end; ++game)
+			{
+				PlaySelfPlayGame(game, options.depth_, *searches[worker_index], &worker_samples[worker_index]);
+			}
+		});
+
+		for (const std::vector<Sample>& buffer : worker_samples)
+		{
+			samples.insert(samples.end(), buffer.begin(), buffer.end());
+		}
+
+		printf("Self-play: %zu games, %zu positions in %.1f s\n", options.games_, samples.size(), 
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	if (samples.empty())
+	{
+		printf("No positions to tune on!\n");
+		return 1;
+	}
+
+	if (!options.save_path_.empty() && !SaveSamples(options.save_path_, samples))
+	{
+		printf("Failed to save positions to %s!\n", options.save_path_.c_str());
+	}
+
+	std::array<double, evaluation::N_FEATURES> weights;
+	const evaluation::Weights initial_weights = Evaluator::Default().GetWeights();
+	std::copy(initial_weights.begin(), initial_weights.end(), weights.begin());
+
+	// Fit the logistic scale to the starting weights first, so the weights only have to learn
+	// relative values.
+	double scale = 1.0;
+	double best_error = Error(pool, samples, weights, scale, nullptr);
+
+	for (double step = 0.5; step > 0.001; step /= 2.0)
+	{
+		for (double candidate : { scale - step, scale + step })
+		{
+			const double error = candidate > 0.0 ? Error(pool, samples, weights, candidate, nullptr) : best_error;
+
+			if (error < best_error)
+			{
+				best_error = error;
+				scale = candidate;
+			}
+		}
+	}
+
+	printf("Scale %.4f, initial error %.6f over %zu positions\n", scale, best_error, samples.size());
+
+	// Adam keeps rarely-active features (e.g. four-missing windows) moving at the same pace as
+	// the dominant ones.
+	constexpr double beta1 = 0.9;
+	constexpr double beta2 = 0.999;
+	constexpr double epsilon = 1e-8;
+
+	std::array<double, evaluation::N_FEATURES> gradient;
+	std::array<double, evaluation::N_FEATURES> moment = {};
+	std::array<double, evaluation::N_FEATURES> velocity = {};
+
+	for (std::size_t epoch = 1; epoch <= options.epochs_; ++epoch)
+	{
+		const double error = Error(pool, samples, weights, scale, &gradient);
+
+		for (std::size_t f = 0; f < evaluation::N_FEATURES; ++f)
+		{
+			moment[f] = beta1 * moment[f] + (1.0 - beta1) * gradient[f];
+			velocity[f] = beta2 * velocity[f] + (1.0 - beta2) * gradient[f] * gradient[f];
+
+			const double moment_hat = moment[f] / (1.0 - std::pow(beta1, epoch));
+			const double velocity_hat = velocity[f] / (1.0 - std::pow(beta2, epoch));
+
+			// The learning rate is relative to a typical weight magnitude (one pawn = 100).
+			weights[f] -= options.rate_ * 100.0 * moment_hat / (std::sqrt(velocity_hat) + epsilon);
+		}
+
+		if (epoch % 50 == 0 || epoch == options.epochs_)
+		{
+			printf("Epoch %zu: error %.6f\n", epoch, error);
+		}
+	}
+
+	evaluation::Weights tuned_weights;
+
+	for (std::size_t f = 0; f < evaluation::N_FEATURES; ++f)
+	{
+		tuned_weights[f] = static_cast<float>(weights[f]);
+		printf("w[%zu] = %.2f\n", f, weights[f]);
+	}
+
+	Evaluator tuned;
+	tuned.SetWeights(tuned_weights);
+
+	if (!tuned.SaveToFile(options.output_path_.c_str()))
+	{
+		printf("Failed to write weights to %s!\n", options.output_path_.c_str());
+		return 1;
+	}
+
+	printf("Final error %.6f, weights written to %s\n", Error(pool, samples, weights, scale, nullptr), options.output_path_.c_str());
+
+	return 0;
+}
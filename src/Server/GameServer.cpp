@@ -0,0 +1,552 @@
+#include "Server/GameServer.hpp"
+#include "Server/Protocol.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "Utils/Constants.hpp"
+#include "Utils/Metrics.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+	constexpr int max_events = 256;
+	constexpr std::size_t worker_table_entries = 1 << 14;
+	constexpr std::size_t read_chunk_size = 16 * 1024;
+} // namespace
+
+GameServer::GameServer(std::size_t n_workers) : 
+	listen_fd_(-1), 
+	epoll_fd_(-1), 
+	event_fd_(-1), 
+	running_(false), 
+	next_session_id_(1), 
+	moves_(0), 
+	games_(0)
+{
+	pool_ = std::make_unique<ThreadPool>(n_workers);
+
+	for (std::size_t i = 0; i < pool_->Workers(); ++i)
+	{
+		searches_.push_back(std::make_unique<Search>(1, worker_table_entries));
+	}
+}
+
+GameServer::~GameServer()
+{
+	pool_.reset();
+
+	for (const auto& connection : connections_)
+	{
+		close(connection.first);
+	}
+
+	if (event_fd_ != -1)
+	{
+		close(event_fd_);
+	}
+
+	if (epoll_fd_ != -1)
+	{
+		close(epoll_fd_);
+	}
+
+	if (listen_fd_ != -1)
+	{
+		close(listen_fd_);
+	}
+}
+
+bool GameServer::Listen(std::uint16_t port)
+{
+	listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (listen_fd_ == -1)
+	{
+		perror("socket");
+		return false;
+	}
+
+	const int enable = 1;
+	setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 || listen(listen_fd_, SOMAXCONN) == -1)
+	{
+		perror("bind/listen");
+		return false;
+	}
+
+	epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+	event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (epoll_fd_ == -1 || event_fd_ == -1)
+	{
+		perror("epoll/eventfd");
+		return false;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = listen_fd_;
+	epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event);
+
+	event.data.fd = event_fd_;
+	epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &event);
+
+	printf("Game server listening on 127.0.0.1:%u with %zu AI workers\n", port, pool_->Workers());
+
+	return true;
+}
+
+void GameServer::Run()
+{
+	running_ = true;
+	last_report_ = std::chrono::steady_clock::now();
+
+	epoll_event events[max_events];
+
+	while (running_)
+	{
+		const int n_events = epoll_wait(epoll_fd_, events, max_events, 1000);
+
+		if (n_events == -1 && errno != EINTR)
+		{
+			perror("epoll_wait");
+			break;
+		}
+
+		for (int i = 0; i < n_events; ++i)
+		{
+			const int fd = events[i].data.fd;
+
+			if (fd == listen_fd_)
+			{
+				Accept();
+			}
+			else if (fd == event_fd_)
+			{
+				std::uint64_t value = 0;
+				ssize_t n_read = read(event_fd_, &value, sizeof(value));
+				(void)n_read;
+
+				DrainCompletions();
+			}
+			else
+			{
+				if (events[i].events & (EPOLLHUP | EPOLLERR))
+				{
+					CloseConnection(fd);
+					continue;
+				}
+
+				if (events[i].events & EPOLLIN)
+				{
+					ReadConnection(fd);
+				}
+
+				if ((events[i].events & EPOLLOUT) && connections_.count(fd) != 0)
+				{
+					FlushConnection(fd);
+				}
+			}
+		}
+
+		if (std::chrono::steady_clock::now() - last_report_ >= std::chrono::seconds(1))
+		{
+			Report();
+		}
+	}
+}
+
+void GameServer::Stop()
+{
+	running_ = false;
+}
+
+void GameServer::Accept()
+{
+	while (true)
+	{
+		const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+		if (fd == -1)
+		{
+			return;
+		}
+
+		const int enable = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+
+		connections_[fd] = Connection{ std::string(), std::string(), {}, false };
+	}
+}
+
+void GameServer::ReadConnection(int fd)
+{
+	char buffer[read_chunk_size];
+
+	while (true)
+	{
+		const ssize_t n_read = read(fd, buffer, sizeof(buffer));
+
+		if (n_read == 0 || (n_read == -1 && errno != EAGAIN && errno != EWOULDBLOCK))
+		{
+			CloseConnection(fd);
+			return;
+		}
+
+		if (n_read == -1)
+		{
+			break;
+		}
+
+		connections_[fd].input_.append(buffer, static_cast<std::size_t>(n_read));
+	}
+
+	std::size_t offset = 0;
+
+	while (connections_.count(fd) != 0)
+	{
+		const std::string& input = connections_[fd].input_;
+
+		if (offset >= input.size())
+		{
+			break;
+		}
+
+		const std::size_t frame_size = protocol::FrameSize(static_cast<std::uint8_t>(input[offset]));
+
+		if (frame_size == 0)
+		{
+			SendError(fd, 0, protocol::ErrorCode::UNKNOWN_OPCODE);
+			CloseConnection(fd);
+			return;
+		}
+
+		if (offset + frame_size > input.size())
+		{
+			break;
+		}
+
+		const std::string frame = input.substr(offset, frame_size);
+		offset += frame_size;
+
+		HandleFrame(fd, frame.data());
+	}
+
+	if (connections_.count(fd) != 0)
+	{
+		connections_[fd].input_.erase(0, offset);
+		FlushConnection(fd);
+	}
+}
+
+void GameServer::FlushConnection(int fd)
+{
+	Connection& connection = connections_[fd];
+
+	while (!connection.output_.empty())
+	{
+		const ssize_t n_written = send(fd, connection.output_.data(), connection.output_.size(), MSG_NOSIGNAL);
+
+		if (n_written == -1)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				CloseConnection(fd);
+				return;
+			}
+
+			break;
+		}
+
+		connection.output_.erase(0, static_cast<std::size_t>(n_written));
+	}
+
+	const bool writing = !connection.output_.empty();
+
+	if (writing != connection.writing_)
+	{
+		epoll_event event = {};
+		event.events = EPOLLIN | (writing ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+		event.data.fd = fd;
+		epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+
+		connection.writing_ = writing;
+	}
+}
+
+void GameServer::CloseConnection(int fd)
+{
+	const auto connection = connections_.find(fd);
+
+	if (connection == connections_.end())
+	{
+		return;
+	}
+
+	for (std::uint32_t session_id : connection->second.sessions_)
+	{
+		sessions_.erase(session_id);
+	}
+
+	epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+	close(fd);
+	connections_.erase(connection);
+}
+
+void GameServer::HandleFrame(int fd, const char* frame)
+{
+	switch (static_cast<protocol::Opcode>(frame[0]))
+	{
+		case protocol::Opcode::NEW:
+			HandleNew(fd, frame);
+			break;
+
+		case protocol::Opcode::MOVE:
+			HandleMove(fd, frame);
+			break;
+
+		case protocol::Opcode::CLOSE:
+			HandleClose(fd, frame);
+			break;
+
+		default:
+			SendError(fd, 0, protocol::ErrorCode::UNKNOWN_OPCODE);
+			break;
+	}
+}
+
+void GameServer::HandleNew(int fd, const char* frame)
+{
+	const std::size_t dimension = protocol::Read<std::uint8_t>(frame + 1);
+	const std::size_t n_symbols_to_win = protocol::Read<std::uint8_t>(frame + 2);
+	const bool ai_first = protocol::Read<std::uint8_t>(frame + 3) != 0;
+
+	if (dimension < 1 || dimension > constants::max_board_dimension || n_symbols_to_win < 1 || n_symbols_to_win > dimension)
+	{
+		SendError(fd, 0, protocol::ErrorCode::INVALID_BOARD);
+		return;
+	}
+
+	const std::uint32_t session_id = next_session_id_++;
+	Session& session = sessions_[session_id];
+
+	session.position_.Reset(dimension, n_symbols_to_win, ai_first ? CellSymbol::O : CellSymbol::X);
+	session.fd_ = fd;
+	session.busy_ = false;
+
+	connections_[fd].sessions_.push_back(session_id);
+	++games_;
+
+	SendSession(fd, session_id);
+
+	if (ai_first)
+	{
+		session.request_time_ = std::chrono::steady_clock::now();
+		RequestAiMove(session_id, session);
+	}
+}
+
+void GameServer::HandleMove(int fd, const char* frame)
+{
+	const std::uint32_t session_id = protocol::Read<std::uint32_t>(frame + 1);
+	const std::size_t cell = protocol::Read<std::uint16_t>(frame + 5);
+
+	const auto found = sessions_.find(session_id);
+
+	if (found == sessions_.end() || found->second.fd_ != fd)
+	{
+		SendError(fd, session_id, protocol::ErrorCode::UNKNOWN_SESSION);
+		return;
+	}
+
+	Session& session = found->second;
+	Position& position = session.position_;
+
+	if (session.busy_ || position.SideToMove() != CellSymbol::X)
+	{
+		SendError(fd, session_id, protocol::ErrorCode::NOT_YOUR_TURN);
+		return;
+	}
+
+	if (cell >= position.Cells() || position.At(cell) != CellSymbol::EMPTY || position.HasWinner())
+	{
+		SendError(fd, session_id, protocol::ErrorCode::INVALID_MOVE);
+		return;
+	}
+
+	session.request_time_ = std::chrono::steady_clock::now();
+	position.MakeMove(cell);
+
+	const protocol::Status status = GameStatus(position, static_cast<int>(cell));
+
+	if (status != protocol::Status::ONGOING)
+	{
+		SendMoveResult(fd, session_id, protocol::no_cell, status);
+		return;
+	}
+
+	RequestAiMove(session_id, session);
+}
+
+void GameServer::HandleClose(int fd, const char* frame)
+{
+	const std::uint32_t session_id = protocol::Read<std::uint32_t>(frame + 1);
+	const auto found = sessions_.find(session_id);
+
+	if (found == sessions_.end() || found->second.fd_ != fd)
+	{
+		SendError(fd, session_id, protocol::ErrorCode::UNKNOWN_SESSION);
+		return;
+	}
+
+	sessions_.erase(found);
+
+	std::vector<std::uint32_t>& owned = connections_[fd].sessions_;
+	owned.erase(std::remove(owned.begin(), owned.end(), session_id), owned.end());
+}
+
+void GameServer::RequestAiMove(std::uint32_t session_id, Session& session)
+{
+	session.busy_ = true;
+
+	const Position position = session.position_;
+
+	pool_->Submit([this, session_id, position](std::size_t worker_index)
+	{
+		const SearchResult result = searches_[worker_index]->Run(position, constants::ai_search_depth);
+
+		{
+			std::lock_guard<std::mutex> lock(completions_mutex_);
+			completions_.push_back({ session_id, result.best_move_ });
+		}
+
+		const std::uint64_t value = 1;
+		ssize_t n_written = write(event_fd_, &value, sizeof(value));
+		(void)n_written;
+	});
+}
+
+void GameServer::DrainCompletions()
+{
+	{
+		std::lock_guard<std::mutex> lock(completions_mutex_);
+		completions_swap_.swap(completions_);
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+
+	for (const Completion& completion : completions_swap_)
+	{
+		const auto found = sessions_.find(completion.session_id_);
+
+		if (found == sessions_.end())
+		{
+			continue;
+		}
+
+		Session& session = found->second;
+		session.busy_ = false;
+		session.position_.MakeMove(completion.move_);
+
+		SendMoveResult(session.fd_, completion.session_id_, static_cast<std::uint16_t>(completion.move_), GameStatus(session.position_, completion.move_));
+
+		const std::uint64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(now - session.request_time_).count();
+		move_latency_us_.Record(latency_us);
+		Metrics::Instance().AiMoveLatency().Record(latency_us);
+		++moves_;
+	}
+
+	for (const Completion& completion : completions_swap_)
+	{
+		const auto found = sessions_.find(completion.session_id_);
+
+		if (found != sessions_.end() && connections_.count(found->second.fd_) != 0)
+		{
+			FlushConnection(found->second.fd_);
+		}
+	}
+
+	completions_swap_.clear();
+}
+
+void GameServer::SendSession(int fd, std::uint32_t session_id)
+{
+	char frame[protocol::FrameSize(static_cast<std::uint8_t>(protocol::Opcode::SESSION))];
+	protocol::Write<std::uint8_t>(frame, static_cast<std::uint8_t>(protocol::Opcode::SESSION));
+	protocol::Write<std::uint32_t>(frame + 1, session_id);
+
+	connections_[fd].output_.append(frame, sizeof(frame));
+}
+
+void GameServer::SendMoveResult(int fd, std::uint32_t session_id, std::uint16_t cell, protocol::Status status)
+{
+	char frame[protocol::FrameSize(static_cast<std::uint8_t>(protocol::Opcode::MOVE_RESULT))];
+	protocol::Write<std::uint8_t>(frame, static_cast<std::uint8_t>(protocol::Opcode::MOVE_RESULT));
+	protocol::Write<std::uint32_t>(frame + 1, session_id);
+	protocol::Write<std::uint16_t>(frame + 5, cell);
+	protocol::Write<std::uint8_t>(frame + 7, static_cast<std::uint8_t>(status));
+
+	connections_[fd].output_.append(frame, sizeof(frame));
+}
+
+void GameServer::SendError(int fd, std::uint32_t session_id, protocol::ErrorCode code)
+{
+	char frame[protocol::FrameSize(static_cast<std::uint8_t>(protocol::Opcode::ERROR))];
+	protocol::Write<std::uint8_t>(frame, static_cast<std::uint8_t>(protocol::Opcode::ERROR));
+	protocol::Write<std::uint32_t>(frame + 1, session_id);
+	protocol::Write<std::uint8_t>(frame + 5, static_cast<std::uint8_t>(code));
+
+	connections_[fd].output_.append(frame, sizeof(frame));
+}
+
+void GameServer::Report()
+{
+	const auto now = std::chrono::steady_clock::now();
+	const std::chrono::duration<double> elapsed = now - last_report_;
+
+	printf("Sessions: %zu, Connections: %zu, Games: %llu, Moves/s: %.0f, AI move latency us p50: %llu p99: %llu max: %llu\n", 
+		sessions_.size(), connections_.size(), static_cast<unsigned long long>(games_), moves_ / elapsed.count(), 
+		static_cast<unsigned long long>(move_latency_us_.Percentile(50.0)), 
+		static_cast<unsigned long long>(move_latency_us_.Percentile(99.0)), 
+		static_cast<unsigned long long>(move_latency_us_.Max()));
+	fflush(stdout);
+
+	move_latency_us_.Reset();
+	moves_ = 0;
+	last_report_ = now;
+}
+
+protocol::Status GameServer::GameStatus(const Position& position, int last_move)
+{
+	if (position.IsWinningMove(last_move))
+	{
+		return position.At(last_move) == CellSymbol::X ? protocol::Status::X_WINS : protocol::Status::O_WINS;
+	}
+
+	return position.FreeCells() == 0 ? protocol::Status::DRAW : protocol::Status::ONGOING;
+}
@@ -0,0 +1,263 @@
+#include "Server/MetricsExporter.hpp"
+#include "Utils/Metrics.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace
+{
+	constexpr std::size_t max_request_size = 4096;
+	constexpr int request_timeout_milliseconds = 200;
+
+	bool SendAll(int fd, const char* data, std::size_t size)
+	{
+		std::size_t offset = 0;
+
+		while (offset < size)
+		{
+			const ssize_t n_written = send(fd, data + offset, size - offset, MSG_NOSIGNAL);
+
+			if (n_written <= 0)
+			{
+				return false;
+			}
+
+			offset += static_cast<std::size_t>(n_written);
+		}
+
+		return true;
+	}
+} // namespace
+
+MetricsExporter::MetricsExporter() : listen_fd_(-1), wake_fd_(-1), interval_(0)
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+	Stop();
+}
+
+bool MetricsExporter::Start(const std::string& path, std::uint16_t port, std::chrono::milliseconds interval)
+{
+	path_ = path;
+	interval_ = interval;
+
+	if (port != 0)
+	{
+		listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+		if (listen_fd_ == -1)
+		{
+			perror("socket");
+			return false;
+		}
+
+		const int enable = 1;
+		setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 || listen(listen_fd_, SOMAXCONN) == -1)
+		{
+			perror("bind/listen");
+			close(listen_fd_);
+			listen_fd_ = -1;
+			return false;
+		}
+	}
+
+	wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (wake_fd_ == -1)
+	{
+		perror("eventfd");
+		return false;
+	}
+
+	// Registers everything before the first frame, so recording never allocates.
+	Metrics::Instance();
+	Export();
+
+	thread_ = std::thread(&MetricsExporter::Loop, this);
+
+	fprintf(stderr, "Exporting metrics every %lld ms", static_cast<long long>(interval_.count()));
+
+	if (!path_.empty())
+	{
+		fprintf(stderr, " to %s", path_.c_str());
+	}
+
+	if (listen_fd_ != -1)
+	{
+		fprintf(stderr, " on http://127.0.0.1:%u/metrics", port);
+	}
+
+	fprintf(stderr, "\n");
+
+	return true;
+}
+
+void MetricsExporter::Stop()
+{
+	if (thread_.joinable())
+	{
+		const std::uint64_t value = 1;
+		ssize_t n_written = write(wake_fd_, &value, sizeof(value));
+		(void)n_written;
+
+		thread_.join();
+
+		// The last interval is not lost on a clean shutdown.
+		Export();
+	}
+
+	if (wake_fd_ != -1)
+	{
+		close(wake_fd_);
+		wake_fd_ = -1;
+	}
+
+	if (listen_fd_ != -1)
+	{
+		close(listen_fd_);
+		listen_fd_ = -1;
+	}
+}
+
+void MetricsExporter::Loop()
+{
+	auto next_export = std::chrono::steady_clock::now() + interval_;
+
+	while (true)
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		if (now >= next_export)
+		{
+			Export();
+			next_export += interval_;
+
+			// A long stall skips exports instead of running them back to back.
+			if (next_export <= now)
+			{
+				next_export = now + interval_;
+			}
+
+			continue;
+		}
+
+		pollfd fds[2] = { { wake_fd_, POLLIN, 0 }, { listen_fd_, POLLIN, 0 } };
+		const int timeout = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(next_export - now).count()) + 1;
+
+		// A negative fd is ignored by poll, so a file-only exporter just sleeps on the wake fd.
+		if (poll(fds, 2, timeout) < 0)
+		{
+			continue;
+		}
+
+		if (fds[0].revents & POLLIN)
+		{
+			return;
+		}
+
+		if (fds[1].revents & POLLIN)
+		{
+			Serve();
+		}
+	}
+}
+
+void MetricsExporter::Export()
+{
+	text_ = Metrics::Instance().Render();
+
+	if (path_.empty())
+	{
+		return;
+	}
+
+	const std::string temporary_path = path_ + ".tmp";
+	FILE* file = fopen(temporary_path.c_str(), "wb");
+
+	if (file == nullptr)
+	{
+		perror(temporary_path.c_str());
+		return;
+	}
+
+	const bool written = fwrite(text_.data(), 1, text_.size(), file) == text_.size();
+
+	if (fclose(file) != 0 || !written || rename(temporary_path.c_str(), path_.c_str()) != 0)
+	{
+		perror(path_.c_str());
+	}
+}
+
+void MetricsExporter::Serve()
+{
+	const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return;
+	}
+
+	// One scraper at a time is plenty, but a stuck client must not hold up the exports.
+	timeval timeout = { 0, request_timeout_milliseconds * 1000 };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	char request[max_request_size + 1];
+	std::size_t size = 0;
+
+	while (size < max_request_size)
+	{
+		const ssize_t n_read = recv(fd, request + size, max_request_size - size, 0);
+
+		if (n_read <= 0)
+		{
+			break;
+		}
+
+		size += static_cast<std::size_t>(n_read);
+		request[size] = '\0';
+
+		if (std::strstr(request, "\r\n\r\n") != nullptr)
+		{
+			break;
+		}
+	}
+
+	request[size] = '\0';
+
+	const bool found = std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET / ", 6) == 0;
+	const std::string& body = found ? text_ : std::string("Not found\n");
+
+	char header[192];
+	const int header_size = snprintf(header, sizeof(header),
+		"HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+		found ? "200 OK" : "404 Not Found", body.size());
+
+	if (SendAll(fd, header, static_cast<std::size_t>(header_size)))
+	{
+		SendAll(fd, body.data(), body.size());
+	}
+
+	close(fd);
+}
@@ -0,0 +1,239 @@
+#include "Utils/AssetPack.hpp"
+#include "SpriteSheet.hpp"
+#include "Texture.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+	Uint8* PixelAt(SDL_Surface* surface, int x, int y)
+	{
+		return static_cast<Uint8*>(surface->pixels) + y * surface->pitch + x * 4;
+	}
+
+	void StorePremultiplied(Uint8* pixel, float r, float g, float b, float a)
+	{
+		if (a <= 0.0f)
+		{
+			pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+			return;
+		}
+
+		pixel[0] = static_cast<Uint8>(std::min(255.0f, r / a + 0.5f));
+		pixel[1] = static_cast<Uint8>(std::min(255.0f, g / a + 0.5f));
+		pixel[2] = static_cast<Uint8>(std::min(255.0f, b / a + 0.5f));
+		pixel[3] = static_cast<Uint8>(std::min(255.0f, a + 0.5f));
+	}
+} // namespace
+
+SpriteSheet::SpriteSheet() : n_sprites_(0)
+{
+}
+
+SpriteSheet::~SpriteSheet()
+{
+	Free();
+}
+
+bool SpriteSheet::Load(const char* name, int n_sprites)
+{
+	Free();
+
+	SDL_Surface* asset_surface = AssetPack::Instance().LoadSurface(name);
+
+	if (asset_surface == nullptr)
+	{
+		return false;
+	}
+
+	// Copy level 0 out of the (possibly read-only, memory-mapped) asset.
+	SDL_Surface* level = SDL_ConvertSurfaceFormat(asset_surface, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(asset_surface);
+
+	if (level == nullptr)
+	{
+		printf("Unable to copy image %s! SDL Error: %s\n", name, SDL_GetError());
+		return false;
+	}
+
+	n_sprites_ = n_sprites;
+	mip_levels_.push_back(level);
+
+	while (level->h >= 16 && level->w / n_sprites_ >= 2)
+	{
+		level = Downscale(level, n_sprites_);
+
+		if (level == nullptr)
+		{
+			break;
+		}
+
+		mip_levels_.push_back(level);
+	}
+
+	return true;
+}
+
+Texture* SpriteSheet::Get(SDL_Renderer* renderer, int sprite_size)
+{
+	for (const auto& cached : cache_)
+	{
+		if (cached.first == sprite_size)
+		{
+			return cached.second.get();
+		}
+	}
+
+	if (mip_levels_.empty() || sprite_size <= 0)
+	{
+		return nullptr;
+	}
+
+	std::size_t level = 0;
+
+	while (level + 1 < mip_levels_.size() && mip_levels_[level + 1]->h >= sprite_size)
+	{
+		++level;
+	}
+
+	SDL_Surface* scaled_surface = Resample(mip_levels_[level], n_sprites_, sprite_size);
+
+	if (scaled_surface == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<Texture> texture = std::make_unique<Texture>();
+	const bool loaded = texture->LoadFromSurface(renderer, scaled_surface);
+	SDL_FreeSurface(scaled_surface);
+
+	if (!loaded)
+	{
+		return nullptr;
+	}
+
+	cache_.emplace_back(sprite_size, std::move(texture));
+
+	return cache_.back().second.get();
+}
+
+SDL_Rect SpriteSheet::Clip(int index, int sprite_size) const
+{
+	return { index * sprite_size, 0, sprite_size, sprite_size };
+}
+
+void SpriteSheet::ClearCache()
+{
+	cache_.clear();
+}
+
+void SpriteSheet::Free()
+{
+	ClearCache();
+
+	for (SDL_Surface* level : mip_levels_)
+	{
+		SDL_FreeSurface(level);
+	}
+
+	mip_levels_.clear();
+}
+
+SDL_Surface* SpriteSheet::Downscale(SDL_Surface* source, int n_sprites)
+{
+	// Halving each sprite rather than the strip keeps every sprite's box inside its own pixels
+	// when a sprite width is odd; the odd column is dropped like an odd row.
+	const int source_sprite_width = source->w / n_sprites;
+	const int target_sprite_width = source_sprite_width / 2;
+
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, target_sprite_width * n_sprites, source->h / 2, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (target == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (int y = 0; y < target->h; ++y)
+	{
+		for (int x = 0; x < target->w; ++x)
+		{
+			const int source_x = (x / target_sprite_width) * source_sprite_width + (x % target_sprite_width) * 2;
+			float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for (int dy = 0; dy < 2; ++dy)
+			{
+				for (int dx = 0; dx < 2; ++dx)
+				{
+					const Uint8* pixel = PixelAt(source, source_x + dx, y * 2 + dy);
+					const float alpha = pixel[3];
+
+					sum[0] += pixel[0] * alpha;
+					sum[1] += pixel[1] * alpha;
+					sum[2] += pixel[2] * alpha;
+					sum[3] += alpha;
+				}
+			}
+
+			StorePremultiplied(PixelAt(target, x, y), sum[0] / 4, sum[1] / 4, sum[2] / 4, sum[3] / 4);
+		}
+	}
+
+	return target;
+}
+
+SDL_Surface* SpriteSheet::Resample(SDL_Surface* source, int n_sprites, int sprite_size)
+{
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, sprite_size * n_sprites, sprite_size, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (target == nullptr)
+	{
+		return nullptr;
+	}
+
+	const int source_sprite_width = source->w / n_sprites;
+	const float x_ratio = static_cast<float>(source_sprite_width) / sprite_size;
+	const float y_ratio = static_cast<float>(source->h) / sprite_size;
+
+	for (int y = 0; y < sprite_size; ++y)
+	{
+		const float source_y = std::clamp((y + 0.5f) * y_ratio - 0.5f, 0.0f, source->h - 1.0f);
+		const int y0 = static_cast<int>(source_y);
+		const int y1 = std::min(y0 + 1, source->h - 1);
+		const float fy = source_y - y0;
+
+		for (int x = 0; x < target->w; ++x)
+		{
+			// Samples are clamped to the sprite's own columns, not the strip's.
+			const int sprite_x = (x / sprite_size) * source_sprite_width;
+			const float source_x = std::clamp((x % sprite_size + 0.5f) * x_ratio - 0.5f, 0.0f, source_sprite_width - 1.0f);
+			const int x0 = static_cast<int>(source_x);
+			const int x1 = std::min(x0 + 1, source_sprite_width - 1);
+			const float fx = source_x - x0;
+
+			const Uint8* samples[4] = { PixelAt(source, sprite_x + x0, y0), PixelAt(source, sprite_x + x1, y0), PixelAt(source, sprite_x + x0, y1), PixelAt(source, sprite_x + x1, y1) };
+			const float weights[4] = { (1 - fx) * (1 - fy), fx * (1 - fy), (1 - fx) * fy, fx * fy };
+
+			float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for (int i = 0; i < 4; ++i)
+			{
+				const float alpha = samples[i][3] * weights[i];
+
+				sum[0] += samples[i][0] * alpha;
+				sum[1] += samples[i][1] * alpha;
+				sum[2] += samples[i][2] * alpha;
+				sum[3] += alpha;
+			}
+
+			StorePremultiplied(PixelAt(target, x, y), sum[0], sum[1], sum[2], sum[3]);
+		}
+	}
+
+	return target;
+}
@@ -1,11 +1,21 @@
+#include "AI/Analysis.hpp"
+#include "AI/BoardEngine.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
 #include "States/BoardState.hpp"
+#include "Utils/AllocationTracker.hpp"
 #include "Utils/Constants.hpp"
+#include "Utils/Metrics.hpp"
 #include "Game.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
 #include <memory>
 #include <vector>
 #include <string>
@@ -19,144 +29,131 @@ BoardState* BoardState::Instance()
 
 bool BoardState::Enter(Game* game)
 {
+	game_ = game;
+
 	InitBoard();
 
 	std::srand(std::time(nullptr));
 	std::rand();
 	player_turn_ = std::rand() % 2;
+	position_.Reset(board_.dimension_, board_.n_symbols_to_win_, player_turn_ ? CellSymbol::X : CellSymbol::O);
 
 	x_score_ = 0;
 	o_score_ = 0;
 	
 	single_player_ = game->GameMode() == GameMode::SINGLE_PLAYER;
 
-	game_ = game;
-	font_ = TTF_OpenFont("res/font/font.ttf", 48);
+	if (single_player_ && search_ == nullptr)
+	{
+		search_ = std::make_unique<Search>();
+	}
 
-	if (font_ == nullptr)
+	pondering_ = false;
+	ponder_requested_ = false;
+	ponder_running_ = false;
+	ponder_exiting_ = false;
+	analysis_enabled_ = false;
+	analysis_generation_ = 0;
+	analysed_hash_ = 0;
+	simulating_ = false;
+	pending_ticks_ = 0;
+	simulated_ticks_ = 0;
+	n_pending_consumed_inputs_ = 0;
+
+	PublishSnapshot();
+
+	if (!board_renderer_.Initialize(game_->GetRenderer()) || !Layout())
 	{
-		printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
 		return false;
 	}
 
-	return InitSymbolsTexture() && InitMessageTextures();
+	if (single_player_)
+	{
+		ponder_thread_ = std::thread(&BoardState::PonderLoop, this);
+	}
+
+	StartSimulation();
+
+	return true;
 }
 
 void BoardState::Exit()
 {
-	TTF_CloseFont(font_);
-	font_ = nullptr;
+	StopSimulation();
+	StopPondering();
+
+	if (ponder_thread_.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(ponder_mutex_);
+			ponder_exiting_ = true;
+		}
 
-	symbols_texture_->FreeTexture();
+		ponder_condition_.notify_all();
+		ponder_thread_.join();
+	}
 
-	for (const std::unique_ptr<Texture>& message_texture : message_textures_)
+	if (analysis_ != nullptr)
 	{
-		message_texture->FreeTexture();
+		analysis_->Clear();
 	}
+
+	board_renderer_.Free();
 }
 
 void BoardState::InitBoard()
 {
-	board_viewport_.x = 0;
-	board_viewport_.y = 0;
-	board_viewport_.w = constants::screen_width;
-	board_viewport_.h = constants::screen_height * 9.0 / 12.0;
-
-	score_viewport_.x = 0;
-	score_viewport_.y = board_viewport_.h;
-	score_viewport_.w = constants::screen_width;
-	score_viewport_.h = constants::screen_height * 3.0 / 12.0;
+	tweens_.Clear();
+	transition_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::transition_seconds), Easing::EASE_IN_OUT);
 
-	constexpr int rect_separator_width = 15;
-	const int rect_side = (board_viewport_.w - (2 * rect_separator_width)) / 3;
-
-	int rect_col = 0;
-	int rect_row = 0;
-
-	for (std::size_t i = 0; i < 9; ++i)
+	for (Cell& board_cell : board_.grid_)
 	{
-		if (i == 3 || i == 6)
-		{
-			rect_col = 0;
-			rect_row += rect_side + rect_separator_width;
-		}
-
-		Cell& board_cell = board_.grid_[i];
-
 		board_cell.symbol_ = CellSymbol::EMPTY;
-		board_cell.rect_.x = rect_col;
-		board_cell.rect_.y = rect_row;
-		board_cell.rect_.w = rect_side;
-		board_cell.rect_.h = rect_side;
 		board_cell.render_win_ = false;
-
-		rect_col += rect_side + rect_separator_width;
+		board_cell.fade_tween_ = invalid_tween;
+		board_cell.win_tween_ = invalid_tween;
 	}
 
 	board_.dimension_ = 3;
 	board_.free_cells_ = board_.grid_.size();
 	board_.n_symbols_to_win_ = board_.dimension_;
+	board_.history_.size_ = 0;
+	board_.history_.redo_size_ = 0;
 	board_.clicked_cell_index_ = -1;
+	board_.clicked_stamp_ = { 0, 0 };
 	board_.win_ = false;
 	board_.win_symbol_ = CellSymbol::EMPTY;
 	board_.reset_ = false;
+	board_.reset_stamp_ = { 0, 0 };
 }
 
-bool BoardState::InitSymbolsTexture()
+bool BoardState::Layout()
 {
-	symbols_texture_ = std::make_unique<Texture>();
-
-	if (!symbols_texture_->LoadFromPath(game_->GetRenderer(), "res/gfx/symbols.png"))
-	{
-		printf("Failed to load symbols texture!\n");
-		return false;
-	}
-
-	constexpr int symbol_dimension = 230;
+	game_->AllowFrameAllocations();
 
-	for (std::size_t i = 0; i < 2; ++i)
-	{
-		symbols_sprites_clips_[i].x = i * symbol_dimension;
-		symbols_sprites_clips_[i].y = 0;
-		symbols_sprites_clips_[i].w = symbol_dimension;
-		symbols_sprites_clips_[i].h = symbol_dimension;
-	}
+	const BoardSnapshot& snapshot = snapshots_.Front();
 
-	return true;
-}
-
-bool BoardState::InitMessageTextures()
-{
-	message_textures_.resize(4);
-
-	const SDL_Color text_color = { 0x00, 0x00, 0x00, 0xFF };
-	const std::vector<std::string> messages = { "TIE", "Press M for menu", std::to_string(x_score_), std::to_string(o_score_) };
-
-	for (std::size_t i = 0; i < message_textures_.size(); ++i)
-	{
-		message_textures_[i] = std::make_unique<Texture>();
-
-		if (!message_textures_[i]->LoadFromText(game_->GetRenderer(), font_, messages[i].c_str(), text_color))
-		{
-			printf("Failed to render text!\n");
-			return false;
-		}
-	}
-
-	return true;
+	return board_renderer_.Layout(game_->ScreenWidth(), game_->ScreenHeight(), game_->UiScale(), snapshot.x_score_, snapshot.o_score_);
 }
 
 void BoardState::ResetBoard()
 {
+	StopPondering();
+
 	for (Cell& cell : board_.grid_)
 	{
 		cell.symbol_ = CellSymbol::EMPTY;
 		cell.render_win_ = false;
+		tweens_.Release(&cell.fade_tween_);
+		tweens_.Release(&cell.win_tween_);
 	}
 
 	player_turn_ = !player_turn_;
+	position_.Reset(board_.dimension_, board_.n_symbols_to_win_, player_turn_ ? CellSymbol::X : CellSymbol::O);
 
 	board_.free_cells_ = board_.grid_.size();
+	board_.history_.size_ = 0;
+	board_.history_.redo_size_ = 0;
 	board_.win_ = false;
 	board_.reset_ = false;
 }
@@ -179,19 +176,40 @@ void BoardState::HandleEvents()
 		{
 			game_->Stop();
 		}
+		else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+		{
+			game_->UpdateScreenSize();
+			Layout();
+		}
 		else if (e.type == SDL_MOUSEBUTTONDOWN)
 		{
-			if (!board_.win_ && board_.free_cells_ != 0 && (!single_player_ || player_turn_))
-			{
-				SetClickedCellIndex();
-			}
-			else
+			int x = e.button.x;
+			int y = e.button.y;
+			game_->WindowToRenderer(&x, &y);
+
+			PushCommand({ BoardCommandType::CLICK, board_renderer_.CellAt(x, y), game_->GetInputLatency()->Stamp() });
+		}
+		else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_a)
+		{
+			if (analysis_ == nullptr)
 			{
-				board_.reset_ = true;
+				game_->AllowFrameAllocations();
+				analysis_ = std::make_unique<Analysis>();
 			}
+
+			PushCommand({ BoardCommandType::ANALYSIS, -1, game_->GetInputLatency()->Stamp() });
+		}
+		else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_u)
+		{
+			PushCommand({ BoardCommandType::UNDO, -1, game_->GetInputLatency()->Stamp() });
+		}
+		else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_r)
+		{
+			PushCommand({ BoardCommandType::REDO, -1, game_->GetInputLatency()->Stamp() });
 		}
 		else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_m)
 		{
+			game_->GetInputLatency()->Consumed(game_->GetInputLatency()->Stamp());
 			game_->SetGameMode(GameMode::NONE);
 			game_->PopState();
 		}
@@ -200,306 +218,428 @@ void BoardState::HandleEvents()
 
 void BoardState::Tick()
 {
-	if (board_.clicked_cell_index_ != -1 && board_.free_cells_ != 0)
-	{
-		board_.grid_[board_.clicked_cell_index_].symbol_ = player_turn_ ? CellSymbol::X : CellSymbol::O;
-		--board_.free_cells_;
+	FlushOverflowCommands();
+	pending_ticks_.fetch_add(1, std::memory_order_release);
+	wake_condition_.notify_one();
+}
 
-		board_.clicked_cell_index_ = -1;
-		
-		board_.win_ = CheckWin(true, &board_.win_symbol_);
+bool BoardState::TicksOnMainThread() const
+{
+	return false;
+}
 
-		if (board_.win_)
-		{
-			player_turn_ ? ++x_score_ : ++o_score_;
-		}
-		else
-		{
-			player_turn_ = !player_turn_;
-		}
+void BoardState::StartSimulation()
+{
+	simulating_ = true;
+	simulation_thread_ = std::thread(&BoardState::SimulationLoop, this);
+}
+
+void BoardState::StopSimulation()
+{
+	if (!simulating_)
+	{
+		return;
 	}
-	else if (single_player_ && !player_turn_ && !board_.win_ && board_.free_cells_ != 0)
+
 	{
-		board_.grid_[BestMove()].symbol_ = CellSymbol::O;
-		--board_.free_cells_;
-		
-		board_.win_ = CheckWin(true, &board_.win_symbol_);
+		std::lock_guard<std::mutex> lock(wake_mutex_);
+		simulating_ = false;
+	}
 
-		if (board_.win_)
-		{			
-			++o_score_;
-		}
-		else
-		{
-			player_turn_ = !player_turn_;
-		}
+	wake_condition_.notify_one();
+	simulation_thread_.join();
+
+	BoardCommand command;
+
+	while (commands_.Pop(&command))
+	{
 	}
-	else if (board_.reset_)
+
+	overflow_commands_.clear();
+	pending_ticks_ = 0;
+}
+
+void BoardState::PushCommand(const BoardCommand& command)
+{
+	if (!FlushOverflowCommands() || !commands_.Push(command))
 	{
-		ResetBoard();
+		game_->AllowFrameAllocations();
+		overflow_commands_.push_back(command);
 	}
+
+	wake_condition_.notify_one();
 }
 
-void BoardState::Render()
+bool BoardState::FlushOverflowCommands()
 {
-	SDL_Renderer* renderer = game_->GetRenderer();
+	std::size_t n_flushed = 0;
 
-	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
-	SDL_RenderClear(renderer);
+	while (n_flushed < overflow_commands_.size() && commands_.Push(overflow_commands_[n_flushed]))
+	{
+		++n_flushed;
+	}
 
-	RenderBoard();
-	RenderInfo();
+	overflow_commands_.erase(overflow_commands_.begin(), overflow_commands_.begin() + n_flushed);
 
-	SDL_RenderPresent(renderer);
+	return overflow_commands_.empty();
 }
 
-void BoardState::RenderBoard()
+void BoardState::SimulationLoop()
 {
-	SDL_Renderer* renderer = game_->GetRenderer();
+	while (simulating_)
+	{
+		const AllocationScope batch_allocations;
+		BoardCommand command;
+		bool changed = false;
 
-	SDL_RenderSetViewport(renderer, &board_viewport_);
-	SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		while (commands_.Pop(&command))
+		{
+			if (command.type_ == BoardCommandType::CLICK)
+			{
+				HandleClick(command);
+			}
+			else if (command.type_ == BoardCommandType::ANALYSIS)
+			{
+				ConsumeInput(command.stamp_);
+				analysis_enabled_ = !analysis_enabled_;
+			}
+			else if (command.type_ == BoardCommandType::UNDO)
+			{
+				ConsumeInput(command.stamp_);
+				Undo();
+			}
+			else if (command.type_ == BoardCommandType::REDO)
+			{
+				ConsumeInput(command.stamp_);
+				Redo();
+			}
 
-	for (const Cell& board_cell : board_.grid_)
-	{
-		SDL_RenderFillRect(renderer, &board_cell.rect_);
+			changed = true;
+		}
 
-		if (board_cell.render_win_)
+		// Input first, so a click that came in with these ticks is played by them. A stalled thread
+		// drops the ticks past the catch-up limit, as Game::Run trims its accumulator.
+		const std::uint64_t max_batch_ticks = static_cast<std::uint64_t>(game_->MaxCatchUpTicks());
+
+		for (std::uint64_t n_ticks = std::min(pending_ticks_.exchange(0, std::memory_order_acquire), max_batch_ticks); n_ticks != 0; --n_ticks)
 		{
-			SDL_SetRenderDrawColor(renderer, 0x00, 0xB4, 0x00, 0xFF);
-			SDL_RenderFillRect(renderer, &board_cell.rect_);
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			const std::uint64_t tick_start = SDL_GetPerformanceCounter();
+			Step();
+			Metrics::Instance().TickTime().Record((SDL_GetPerformanceCounter() - tick_start) * 1000000 / SDL_GetPerformanceFrequency());
+			++simulated_ticks_;
+			changed = true;
 		}
 
-		if (board_cell.symbol_ != CellSymbol::EMPTY)
+		if (changed)
 		{
-			const int symbol_sprite_index = board_cell.symbol_ == CellSymbol::X;
-			symbols_texture_->Render(renderer, board_cell.rect_.x, board_cell.rect_.y, &symbols_sprites_clips_[symbol_sprite_index], 1.0);	
+			UpdateAnalysis();
+			PublishSnapshot();
+
+			for (std::size_t i = 0; i < n_pending_consumed_inputs_; ++i)
+			{
+				consumed_inputs_.Push(pending_consumed_inputs_[i]);
+			}
+
+			n_pending_consumed_inputs_ = 0;
+
+			// Ticks run here rather than in Game::Run's frame scope, so they get their own check.
+			if (simulated_ticks_ > static_cast<std::uint64_t>(constants::allocation_warmup_frames))
+			{
+				AllocationTracker::ExpectNone("tick", batch_allocations.Stats());
+			}
 		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex_);
+		wake_condition_.wait_for(lock, std::chrono::milliseconds(5), [this]() { return !simulating_ || !commands_.Empty() || pending_ticks_.load(std::memory_order_relaxed) != 0; });
 	}
-	
-	SDL_RenderSetViewport(renderer, NULL);
 }
 
-void BoardState::RenderInfo()
+void BoardState::HandleClick(const BoardCommand& command)
 {
-	SDL_Renderer* renderer = game_->GetRenderer();
+	if (!board_.win_ && board_.free_cells_ != 0 && (!single_player_ || player_turn_))
+	{
+		SetClickedCellIndex(command.cell_, command.stamp_);
+	}
+	else
+	{
+		board_.reset_ = true;
+		board_.reset_stamp_ = command.stamp_;
+	}
+}
+
+void BoardState::PlaceSymbol(std::size_t index, CellSymbol symbol)
+{
+	Cell& cell = board_.grid_[index];
 
-	SDL_RenderSetViewport(renderer, &score_viewport_);
-	SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+	cell.symbol_ = symbol;
+	cell.fade_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::symbol_fade_seconds), Easing::EASE_OUT_CUBIC);
+	--board_.free_cells_;
+}
 
-	const SDL_Rect info_background_rect = { 0, 0, score_viewport_.w, score_viewport_.h };
-	SDL_RenderFillRect(renderer, &info_background_rect);
+void BoardState::MakeMove(std::size_t index, bool redo)
+{
+	PlaceSymbol(index, player_turn_ ? CellSymbol::X : CellSymbol::O);
+	position_.MakeMove(index);
 
-	const double symbols_scale = 0.25;
-	const SDL_Rect& symbol_rect = symbols_sprites_clips_[0];
+	MoveHistory& history = board_.history_;
+	history.moves_[history.size_++] = index;
 
-	const int o_x = score_viewport_.w * 2 / 7;
-	const int o_y = score_viewport_.h * 1 / 6;
+	if (!redo)
+	{
+		history.redo_size_ = history.size_;
+	}
 
-	symbols_texture_->Render(renderer, o_x, o_y, &symbols_sprites_clips_[0], symbols_scale);
+	// Only lines through the new stone can have been completed; the full scan just marks them.
+	board_.win_ = position_.IsWinningMove(index) && CheckWin(true, &board_.win_symbol_);
 
-	const int x_x = score_viewport_.w * 5 / 7 - (symbol_rect.w * symbols_scale);
-	const int x_y = score_viewport_.h * 1 / 6;
+	if (board_.win_)
+	{
+		player_turn_ ? ++x_score_ : ++o_score_;
+	}
+	else
+	{
+		player_turn_ = !player_turn_;
+	}
+}
 
-	symbols_texture_->Render(renderer, x_x, x_y, &symbols_sprites_clips_[1], symbols_scale);
+void BoardState::PlayMoveSound(std::uint64_t click_counter)
+{
+	const Sound sound = board_.win_ ? Sound::WIN : (board_.free_cells_ == 0 ? Sound::TIE : Sound::PLACE);
 
-	const int x_score_msg_index = static_cast<int>(MessageType::X_SCORE);
-	const int o_score_msg_index = static_cast<int>(MessageType::O_SCORE);
+	game_->GetAudio()->Play(sound, click_counter);
+}
 
-	message_textures_[o_score_msg_index]->Render(renderer, o_x + ((symbol_rect.w * symbols_scale / 2) - message_textures_[o_score_msg_index]->Width() / 2), score_viewport_.h / 2);
-	message_textures_[x_score_msg_index]->Render(renderer, x_x + ((symbol_rect.w * symbols_scale / 2) - message_textures_[x_score_msg_index]->Width() / 2), score_viewport_.h / 2);
+bool BoardState::UndoMove()
+{
+	MoveHistory& history = board_.history_;
 
-	if (!board_.win_)
+	if (history.size_ == 0)
 	{
-		SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+		return false;
+	}
 
-		if (board_.free_cells_ == 0)
-		{
-			const int tie_msg_index = static_cast<int>(MessageType::TIE);
+	const std::size_t index = history.moves_[--history.size_];
 
-			message_textures_[tie_msg_index]->Render(renderer, 
-													(score_viewport_.w / 2) - (message_textures_[tie_msg_index]->Width() / 2), 
-													o_y * 2);
-		}
-		else
-		{
-			const int line_x = (player_turn_ || single_player_) ? x_x : o_x;
-			const int line_y = (player_turn_ || single_player_) ? x_y : o_y;
+	// The game stops at a win, so a won board can only be undone by taking back the winning move;
+	// its mover kept the turn.
+	if (board_.win_)
+	{
+		player_turn_ ? --x_score_ : --o_score_;
+		board_.win_ = false;
 
-			for (std::size_t i = 5; i < 10; ++i)
-			{
-				SDL_RenderDrawLine(renderer, line_x, line_y + i + symbol_rect.h * symbols_scale, line_x + symbol_rect.w * symbols_scale, line_y + i + symbol_rect.h * symbols_scale);
-			}
+		for (Cell& cell : board_.grid_)
+		{
+			cell.render_win_ = false;
+			tweens_.Release(&cell.win_tween_);
 		}
-		
-		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);	
 	}
 	else
 	{
-		const int score_msg_index = static_cast<int>(player_turn_ ? MessageType::X_SCORE : MessageType::O_SCORE);
-		const std::string updated_score = std::to_string(player_turn_ ? x_score_ : o_score_);
+		player_turn_ = !player_turn_;
+	}
 
-		if (!message_textures_[score_msg_index]->LoadFromText(game_->GetRenderer(), font_, updated_score.c_str(), { 0x00, 0x00, 0x00, 0xFF }))
-		{
-			printf("Failed to render score text!\n");
-		}
+	Cell& cell = board_.grid_[index];
+	cell.symbol_ = CellSymbol::EMPTY;
+	tweens_.Release(&cell.fade_tween_);
+	++board_.free_cells_;
+
+	position_.UnmakeMove(index);
+
+	return true;
+}
+
+bool BoardState::RedoMove()
+{
+	const MoveHistory& history = board_.history_;
+
+	if (history.size_ == history.redo_size_ || board_.win_)
+	{
+		return false;
 	}
 
-	const int menu_msg_index = static_cast<int>(MessageType::MENU);
+	MakeMove(history.moves_[history.size_], true);
 
-	message_textures_[menu_msg_index]->Render(renderer, (score_viewport_.w / 2) - (message_textures_[menu_msg_index]->Width() / 2), score_viewport_.h - message_textures_[menu_msg_index]->Height());
+	return true;
+}
+
+void BoardState::Undo()
+{
+	StopPondering();
 
-	SDL_RenderSetViewport(renderer, NULL);
+	board_.clicked_cell_index_ = -1;
+
+	while (UndoMove() && single_player_ && !player_turn_)
+	{
+	}
 }
 
-void BoardState::SetClickedCellIndex()
+void BoardState::Redo()
 {
-	SDL_Point mouse_position = { 0, 0 };
-	SDL_GetMouseState(&mouse_position.x, &mouse_position.y);
-	
-	//printf("%d %d\n", mouse_position.x, mouse_position.y);
+	StopPondering();
 
-	for (std::size_t i = 0; i < board_.grid_.size(); ++i)
+	board_.clicked_cell_index_ = -1;
+
+	while (RedoMove() && single_player_ && !player_turn_)
 	{
-		if (board_.grid_[i].symbol_ == CellSymbol::EMPTY && SDL_PointInRect(&mouse_position, &board_.grid_[i].rect_))
-	 	{
-	 		board_.clicked_cell_index_ = i;
-	 		return;
-		}
 	}
 }
 
-bool BoardState::CheckWin(bool set_render_win_flag, CellSymbol* winning_symbol)
+void BoardState::ConsumeInput(const InputStamp& stamp)
 {
-	return CheckRowsColsWin(set_render_win_flag, winning_symbol) || CheckDiagonalsWin(set_render_win_flag, winning_symbol);
+	if (n_pending_consumed_inputs_ < pending_consumed_inputs_.size())
+	{
+		pending_consumed_inputs_[n_pending_consumed_inputs_++] = { stamp, SDL_GetPerformanceCounter() };
+	}
 }
 
-bool BoardState::CheckRowsColsWin(bool set_render_win_flag, CellSymbol* winning_symbol)
+void BoardState::PublishSnapshot()
 {
-	std::vector<std::size_t> rows_winning_indices;
-	std::vector<std::size_t> cols_winning_indices;
-	
-	rows_winning_indices.reserve(board_.n_symbols_to_win_);
-	cols_winning_indices.reserve(board_.n_symbols_to_win_);
+	BoardSnapshot& snapshot = snapshots_.Back();
 
-	for (std::size_t i = 0; i < board_.dimension_; i++)
+	for (std::size_t i = 0; i < board_.grid_.size(); ++i)
 	{
-	    for (std::size_t j = 0; j < board_.dimension_; j++)
-	    {
-			const std::size_t row_index = i * board_.dimension_ + j;
+		snapshot.symbols_[i] = board_.grid_[i].symbol_;
+		snapshot.render_win_[i] = board_.grid_[i].render_win_;
+		snapshot.symbol_fade_[i] = tweens_.Value(board_.grid_[i].fade_tween_);
+		snapshot.symbol_fade_next_[i] = tweens_.Value(board_.grid_[i].fade_tween_, 1.0f);
+		snapshot.win_fade_[i] = tweens_.Value(board_.grid_[i].win_tween_);
+		snapshot.win_fade_next_[i] = tweens_.Value(board_.grid_[i].win_tween_, 1.0f);
+	}
+
+	snapshot.transition_ = tweens_.Value(transition_tween_);
+	snapshot.transition_next_ = tweens_.Value(transition_tween_, 1.0f);
 
-	    	if (CheckSymbolsWin(row_index, &rows_winning_indices, set_render_win_flag, winning_symbol))
-	    	{
-	    		return true;
-	    	}
+	snapshot.free_cells_ = board_.free_cells_;
+	snapshot.win_ = board_.win_;
+	snapshot.player_turn_ = player_turn_;
+	snapshot.x_score_ = x_score_;
+	snapshot.o_score_ = o_score_;
+	snapshot.analysis_ = analysis_generation_ != 0;
+	snapshot.analysis_generation_ = analysis_generation_;
 
-			const std::size_t col_index = j * board_.dimension_ + i;
+	snapshots_.Publish();
+}
 
-	    	if (CheckSymbolsWin(col_index, &cols_winning_indices, set_render_win_flag, winning_symbol))
-	    	{
-	    		return true;
-	    	}
-	    }
+void BoardState::UpdateAnalysis()
+{
+	if (!analysis_enabled_ || board_.win_ || board_.free_cells_ == 0)
+	{
+		if (analysis_generation_ != 0)
+		{
+			analysis_->Clear();
+			analysis_generation_ = 0;
+		}
 
-		rows_winning_indices.clear();
-		cols_winning_indices.clear();
+		return;
 	}
 
-	return false;
+	if (analysis_generation_ != 0 && position_.Hash() == analysed_hash_)
+	{
+		return;
+	}
+
+	analysed_hash_ = position_.Hash();
+	analysis_generation_ = analysis_->SetPosition(position_);
 }
-	
-bool BoardState::CheckDiagonalsWin(bool set_render_win_flag, CellSymbol* winning_symbol)
+
+void BoardState::Step()
 {
-	const int board_dim = static_cast<int>(board_.dimension_);
+	tweens_.Update();
+
+	if (board_.clicked_cell_index_ != -1 && board_.free_cells_ != 0)
+	{
+		StopPondering();
 
-	std::vector<std::size_t> winning_indices;
-	winning_indices.reserve(board_.n_symbols_to_win_);
+		ConsumeInput(board_.clicked_stamp_);
 
-	for (int i = 0; i < board_dim * 2; i++)
+		MakeMove(board_.clicked_cell_index_);
+		PlayMoveSound(board_.clicked_stamp_.counter_);
+
+		board_.clicked_cell_index_ = -1;
+	}
+	else if (single_player_ && !player_turn_ && !board_.win_ && board_.free_cells_ != 0)
 	{
-		for (int j = 0; j <= i; j++)
-		{
-			const int k = i - j;
-			
-			if (k < board_dim && j < board_dim)
-			{
-				const int index = k * board_dim + j;
-				assert(index >= 0);
+		MakeMove(BestMove());
+		PlayMoveSound(0);
+	}
+	else if (board_.reset_)
+	{
+		ConsumeInput(board_.reset_stamp_);
+		ResetBoard();
+	}
+	else if (single_player_ && player_turn_ && !board_.win_ && board_.free_cells_ != 0)
+	{
+		StartPondering();
+	}
+}
 
-				if (CheckSymbolsWin(static_cast<std::size_t>(index), &winning_indices, set_render_win_flag, winning_symbol))
-		    	{
-		    		return true;
-		    	}
-			}
-		}
+void BoardState::Render(double alpha)
+{
+	ConsumedInput consumed_input;
 
-		winning_indices.clear();
+	while (consumed_inputs_.Pop(&consumed_input))
+	{
+		game_->GetInputLatency()->Consumed(consumed_input.stamp_, consumed_input.consumed_counter_);
 	}
 
-	winning_indices.clear();
+	const BoardSnapshot& snapshot = snapshots_.Front();
 
-	int l = 0;
+	SDL_Renderer* renderer = game_->GetRenderer();
 
-	for (int i = 0; i < board_dim * 2; i++)
+	const AnalysisResult* analysis = nullptr;
+
+	if (snapshot.analysis_)
 	{
-		if (i >= board_dim)
-		{
-			++l;
-		}
+		const AnalysisResult& latest = analysis_->Latest();
 
-		for (int j = 0; j <= i; j++)
+		if (latest.generation_ == snapshot.analysis_generation_)
 		{
-			const int k = board_dim - j - 1;
-			
-			if (k >= 0 && k - l >= 0)
-			{
-				const int index = (i - j - l) * board_dim + (k - l);
-				assert(index >= 0);
-
-				if (CheckSymbolsWin(static_cast<std::size_t>(index), &winning_indices, set_render_win_flag, winning_symbol))
-		    	{
-		    		return true;
-		    	}
-			}
+			analysis = &latest;
 		}
-
-		winning_indices.clear();
 	}
 
-	return false;
+	board_renderer_.Render(snapshot, static_cast<float>(alpha), single_player_, analysis);
+
+	RenderTransition(renderer, snapshot.transition_ + (snapshot.transition_next_ - snapshot.transition_) * static_cast<float>(alpha));
+
+	SDL_RenderPresent(renderer);
+	game_->GetInputLatency()->Presented();
 }
 
-bool BoardState::CheckSymbolsWin(std::size_t index, std::vector<std::size_t>* winning_indices, bool set_render_win_flag, CellSymbol* winning_symbol)
+void BoardState::SetClickedCellIndex(int cell, const InputStamp& stamp)
 {
-	assert(winning_indices != nullptr);
-
-	if (board_.grid_[index].symbol_ == CellSymbol::EMPTY)
+	if (cell >= 0 && board_.grid_[cell].symbol_ == CellSymbol::EMPTY)
 	{
-		winning_indices->clear();
-		return false;
+		board_.clicked_cell_index_ = cell;
+		board_.clicked_stamp_ = stamp;
 	}
+}
 
-	if (!winning_indices->empty() && board_.grid_[index].symbol_ != board_.grid_[winning_indices->back()].symbol_)
+bool BoardState::CheckWin(bool set_render_win_flag, CellSymbol* winning_symbol)
+{
+	for (const board_engine::Line<3>& line : BoardEngine<3, 3>::lines)
 	{
-		winning_indices->clear();
-	}
-	
-	winning_indices->push_back(index);
+		const CellSymbol symbol = board_.grid_[line[0]].symbol_;
+
+		if (symbol == CellSymbol::EMPTY || board_.grid_[line[1]].symbol_ != symbol || board_.grid_[line[2]].symbol_ != symbol)
+		{
+			continue;
+		}
 
-	if (winning_indices->size() == board_.n_symbols_to_win_)
-	{
 		if (set_render_win_flag)
 		{
-			for (std::size_t winning_index : *winning_indices)
+			for (std::size_t i = 0; i < line.size(); ++i)
 			{
-				board_.grid_[winning_index].render_win_ = true;
+				Cell& winning_cell = board_.grid_[line[i]];
+
+				winning_cell.render_win_ = true;
+				winning_cell.win_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::win_sweep_seconds), Easing::EASE_OUT_CUBIC, static_cast<int>(i) * game_->SecondsToTicks(constants::win_sweep_delay_seconds));
 			}
 		}
 
 		if (winning_symbol != nullptr)
 		{
-			*winning_symbol = board_.grid_[(*winning_indices)[0]].symbol_;
+			*winning_symbol = symbol;
 		}
 
 		return true;
@@ -510,75 +650,77 @@ bool BoardState::CheckSymbolsWin(std::size_t index, std::vector<std::size_t>* wi
 
 int BoardState::BestMove()
 {
-	int best_score = std::numeric_limits<int>::max();
-	int best_index = 0;
+	const auto start = std::chrono::steady_clock::now();
+	const SearchResult result = search_->Run(position_, constants::ai_search_depth);
 
-	for (std::size_t i = 0; i < board_.grid_.size(); ++i)
-	{
-		if (board_.grid_[i].symbol_ == CellSymbol::EMPTY)
-		{
-			board_.grid_[i].symbol_ = CellSymbol::O;
-			--board_.free_cells_;
+	Metrics::Instance().AiMoveLatency().Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
 
-			int score = Minimax(0, true);
+	return result.best_move_;
+}
 
-			board_.grid_[i].symbol_ = CellSymbol::EMPTY;
-			++board_.free_cells_;
+void BoardState::StartPondering()
+{
+	if (pondering_)
+	{
+		return;
+	}
 
-			if (score < best_score)
-			{
-				best_score = score;
-				best_index = i;
-			}
-		}
+	// Search one ply deeper than BestMove from the human's side, so every reply the human can
+	// make leaves a table entry at exactly the depth BestMove will ask for.
+	{
+		std::lock_guard<std::mutex> lock(ponder_mutex_);
+		ponder_position_ = position_;
+		ponder_requested_ = true;
+		ponder_running_ = true;
 	}
 
-	return best_index;
+	ponder_condition_.notify_all();
+	pondering_ = true;
 }
 
-int BoardState::Minimax(int depth, bool is_maximizing)
+void BoardState::PonderLoop()
 {
-	CellSymbol win_symbol = CellSymbol::EMPTY;
-	const bool win = CheckWin(false, &win_symbol);
+	std::unique_lock<std::mutex> lock(ponder_mutex_);
 
-	if (win || depth == 2)
+	while (true)
 	{
-		if (win_symbol == CellSymbol::X)
-		{
-			return 1;
-		}
-		else if (win_symbol == CellSymbol::O)
-		{
-			return -1;
-		}
-		else
+		ponder_condition_.wait(lock, [this]() { return ponder_exiting_ || ponder_requested_; });
+
+		if (ponder_exiting_)
 		{
-			return 0;
+			return;
 		}
+
+		ponder_requested_ = false;
+		const Position position = ponder_position_;
+
+		lock.unlock();
+		search_->Run(position, constants::ai_search_depth + 1);
+		lock.lock();
+
+		ponder_running_ = false;
+		ponder_condition_.notify_all();
 	}
+}
 
-	if (board_.free_cells_ == 0)
+void BoardState::StopPondering()
+{
+	if (!pondering_)
 	{
-		return 0;
+		return;
 	}
 
-	int best_index = is_maximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+	// Run clears the stop flag when it starts, but not the deadline, so a search that has not
+	// started yet still ends at once.
+	search_->Stop();
+	search_->SetDeadline(std::chrono::steady_clock::now());
 
-	for (std::size_t i = 0; i < board_.grid_.size(); ++i)
 	{
-		if (board_.grid_[i].symbol_ == CellSymbol::EMPTY)
-		{
-			board_.grid_[i].symbol_ = is_maximizing ? CellSymbol::X : CellSymbol::O;
-			--board_.free_cells_;
-
-			int index = Minimax(depth + 1, !is_maximizing);
-			
-			board_.grid_[i].symbol_ = CellSymbol::EMPTY;
-			++board_.free_cells_;
-			
-			best_index = is_maximizing ? std::max(index, best_index) : std::min(index, best_index);
-		}
+		std::unique_lock<std::mutex> lock(ponder_mutex_);
+		ponder_condition_.wait(lock, [this]() { return !ponder_running_; });
 	}
 
-	return best_index;
+	search_->ClearDeadline();
+
+	pondering_ = false;
 }
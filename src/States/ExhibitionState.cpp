@@ -0,0 +1,303 @@
+#include "AI/BoardEngine.hpp"
+#include "AI/Position.hpp"
+#include "AI/Search.hpp"
+#include "States/ExhibitionState.hpp"
+#include "Utils/Constants.hpp"
+#include "AiJobs.hpp"
+#include "Game.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <memory>
+
+namespace
+{
+	// Exhibition searches only see 3x3 positions, so a small table per worker is plenty.
+	constexpr std::size_t search_table_entries = 1 << 14;
+
+	float Fade(int elapsed_ticks, int duration_ticks)
+	{
+		return std::clamp(static_cast<float>(elapsed_ticks) / duration_ticks, 0.0f, 1.0f);
+	}
+} // namespace
+
+std::unique_ptr<ExhibitionState> ExhibitionState::exhibition_state_ = std::make_unique<ExhibitionState>();
+
+ExhibitionState* ExhibitionState::Instance()
+{
+	return exhibition_state_.get();
+}
+
+void ExhibitionState::SetBoards(std::size_t n_boards)
+{
+	n_boards_ = std::clamp(n_boards, constants::exhibition_min_boards, constants::exhibition_max_boards);
+}
+
+bool ExhibitionState::Enter(Game* game)
+{
+	game_ = game;
+	tick_ = 0;
+	random_.seed(static_cast<std::uint32_t>(std::time(nullptr)));
+
+	tweens_.Clear();
+	transition_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::transition_seconds), Easing::EASE_IN_OUT);
+
+	jobs_.Attach(game_);
+
+	if (searches_.empty())
+	{
+		for (std::size_t i = 0; i < jobs_.Workers(); ++i)
+		{
+			searches_.push_back(std::make_unique<Search>(1, search_table_entries));
+		}
+	}
+
+	for (std::size_t i = 0; i < n_boards_; ++i)
+	{
+		ResetGame(&games_[i]);
+	}
+
+	return board_batch_.Initialize(game_->GetRenderer(), constants::exhibition_max_boards) && Layout();
+}
+
+void ExhibitionState::Exit()
+{
+	StopThinking();
+
+	board_batch_.Free();
+}
+
+bool ExhibitionState::Layout()
+{
+	game_->AllowFrameAllocations();
+
+	const int n_boards = static_cast<int>(n_boards_);
+	const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n_boards))));
+	const int rows = (n_boards + columns - 1) / columns;
+	const int tile = std::max(1, std::min(game_->ScreenWidth() / columns, game_->ScreenHeight() / rows));
+
+	const int separator_width = std::max(1, tile / 40);
+	const int margin = std::max(2, tile / 12);
+
+	if (!board_batch_.Layout(std::max(1, (tile - margin - 2 * separator_width) / 3), separator_width))
+	{
+		return false;
+	}
+
+	const int inset = (tile - board_batch_.BoardSide()) / 2;
+	const int grid_x = (game_->ScreenWidth() - columns * tile) / 2;
+	const int grid_y = (game_->ScreenHeight() - rows * tile) / 2;
+
+	for (int i = 0; i < n_boards; ++i)
+	{
+		board_origins_[i] = { grid_x + (i % columns) * tile + inset, grid_y + (i / columns) * tile + inset };
+	}
+
+	return true;
+}
+
+void ExhibitionState::Pause()
+{
+}
+
+void ExhibitionState::Resume()
+{
+}
+
+void ExhibitionState::HandleEvents()
+{
+	SDL_Event e;
+
+	while (SDL_PollEvent(&e) != 0)
+	{
+		if (e.type == SDL_QUIT)
+		{
+			game_->Stop();
+		}
+		else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+		{
+			game_->UpdateScreenSize();
+			Layout();
+		}
+		else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_m)
+		{
+			game_->GetInputLatency()->Consumed(game_->GetInputLatency()->Stamp());
+			game_->SetGameMode(GameMode::NONE);
+			game_->PopState();
+		}
+	}
+}
+
+void ExhibitionState::Tick()
+{
+	tweens_.Update();
+	++tick_;
+
+	for (std::size_t i = 0; i < n_boards_; ++i)
+	{
+		ExhibitionGame& game = games_[i];
+
+		if (game.awaiting_move_)
+		{
+			const int chosen_move = game.chosen_move_.load(std::memory_order_acquire);
+
+			if (chosen_move >= 0)
+			{
+				game.awaiting_move_ = false;
+				PlayMove(&game, static_cast<std::size_t>(chosen_move));
+			}
+		}
+		else if (tick_ >= game.next_tick_)
+		{
+			if (game.over_)
+			{
+				ResetGame(&game);
+			}
+			else if (game.n_random_moves_ > 0)
+			{
+				// A random opening or two keeps the boards from all playing the same game.
+				--game.n_random_moves_;
+
+				std::size_t index = random_() % game.position_.Cells();
+
+				while (game.position_.At(index) != CellSymbol::EMPTY)
+				{
+					index = (index + 1) % game.position_.Cells();
+				}
+
+				PlayMove(&game, index);
+			}
+			else
+			{
+				StartThinking(i);
+			}
+		}
+	}
+}
+
+void ExhibitionState::Render(double alpha)
+{
+	SDL_Renderer* renderer = game_->GetRenderer();
+
+	SDL_RenderSetViewport(renderer, NULL);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+	SDL_RenderClear(renderer);
+
+	board_batch_.Begin();
+
+	for (std::size_t i = 0; i < n_boards_; ++i)
+	{
+		FillSnapshot(games_[i]);
+		board_batch_.AddBoard(snapshot_, board_origins_[i].x, board_origins_[i].y, static_cast<float>(alpha));
+	}
+
+	board_batch_.Submit();
+
+	RenderTransition(renderer, tweens_.Value(transition_tween_, static_cast<float>(alpha)));
+
+	SDL_RenderPresent(renderer);
+	game_->GetInputLatency()->Presented();
+}
+
+void ExhibitionState::ResetGame(ExhibitionGame* game)
+{
+	game->position_.Reset(3, 3, random_() % 2 == 0 ? CellSymbol::X : CellSymbol::O);
+	game->placed_tick_.fill(0);
+	game->render_win_.fill(false);
+	game->win_tick_ = 0;
+	game->n_random_moves_ = 1 + random_() % 2;
+	game->over_ = false;
+	game->awaiting_move_ = false;
+
+	// Staggered so the boards do not all move on the same tick.
+	game->next_tick_ = tick_ + static_cast<int>(random_() % game_->SecondsToTicks(constants::exhibition_move_seconds));
+}
+
+void ExhibitionState::PlayMove(ExhibitionGame* game, std::size_t index)
+{
+	if (index >= game->position_.Cells() || game->position_.At(index) != CellSymbol::EMPTY)
+	{
+		return;
+	}
+
+	game->position_.MakeMove(index);
+	game->placed_tick_[index] = tick_;
+	game->next_tick_ = tick_ + game_->SecondsToTicks(constants::exhibition_move_seconds);
+
+	if (game->position_.IsWinningMove(index))
+	{
+		const CellSymbol symbol = game->position_.At(index);
+
+		for (const board_engine::Line<3>& line : BoardEngine<3, 3>::lines)
+		{
+			if (std::all_of(line.begin(), line.end(), [&](std::size_t cell) { return game->position_.At(cell) == symbol; }))
+			{
+				for (const std::size_t cell : line)
+				{
+					game->render_win_[cell] = true;
+				}
+			}
+		}
+
+		game->win_tick_ = tick_;
+		game->over_ = true;
+		game->next_tick_ = tick_ + game_->SecondsToTicks(constants::exhibition_result_seconds);
+	}
+	else if (game->position_.FreeCells() == 0)
+	{
+		game->over_ = true;
+		game->next_tick_ = tick_ + game_->SecondsToTicks(constants::exhibition_result_seconds);
+	}
+}
+
+void ExhibitionState::StartThinking(std::size_t game_index)
+{
+	ExhibitionGame& game = games_[game_index];
+
+	game.awaiting_move_ = true;
+	game.chosen_move_.store(-1, std::memory_order_relaxed);
+
+	jobs_.Submit([this, game_index](std::size_t worker_index)
+	{
+		ExhibitionGame& thinking_game = games_[game_index];
+
+		thinking_game.chosen_move_.store(searches_[worker_index]->Run(thinking_game.position_, constants::ai_search_depth).best_move_, std::memory_order_release);
+	});
+}
+
+void ExhibitionState::StopThinking()
+{
+	jobs_.Stop(searches_);
+
+	for (std::size_t i = 0; i < n_boards_; ++i)
+	{
+		games_[i].awaiting_move_ = false;
+	}
+
+	for (const std::unique_ptr<Search>& search : searches_)
+	{
+		search->ClearDeadline();
+	}
+}
+
+void ExhibitionState::FillSnapshot(const ExhibitionGame& game)
+{
+	const int symbol_fade_ticks = game_->SecondsToTicks(constants::symbol_fade_seconds);
+	const int win_sweep_ticks = game_->SecondsToTicks(constants::win_sweep_seconds);
+
+	for (std::size_t i = 0; i < snapshot_.symbols_.size(); ++i)
+	{
+		snapshot_.symbols_[i] = game.position_.At(i);
+		snapshot_.symbol_fade_[i] = Fade(tick_ - game.placed_tick_[i], symbol_fade_ticks);
+		snapshot_.symbol_fade_next_[i] = Fade(tick_ + 1 - game.placed_tick_[i], symbol_fade_ticks);
+		snapshot_.render_win_[i] = game.render_win_[i];
+		snapshot_.win_fade_[i] = Fade(tick_ - game.win_tick_, win_sweep_ticks);
+		snapshot_.win_fade_next_[i] = Fade(tick_ + 1 - game.win_tick_, win_sweep_ticks);
+	}
+}
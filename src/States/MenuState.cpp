@@ -1,13 +1,17 @@
 #include "Button.hpp"
 #include "States/BoardState.hpp"
 #include "States/MenuState.hpp"
+#include "Utils/AssetPack.hpp"
 #include "Utils/Constants.hpp"
 #include "Game.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <vector>
 #include <string>
@@ -22,19 +26,39 @@ MenuState* MenuState::Instance()
 bool MenuState::Enter(Game* game)
 {
 	game_ = game;
-	font_ = TTF_OpenFont("res/font/font.ttf", 58);
+	font_ = nullptr;
+	assets_ready_ = false;
+
+	tweens_.Clear();
+	transition_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::transition_seconds), Easing::EASE_IN_OUT);
+
+	title_texture_ = std::make_unique<Texture>();
 
-	if (font_ == nullptr)
+	const std::vector<std::string> menu_texts = { "Singleplayer", "Multiplayer", "Qubic", "Ultimate", "Exhibition" };
+
+	menu_buttons_.resize(menu_texts.size());
+
+	for (std::size_t i = 0; i < menu_texts.size(); ++i)
 	{
-		printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
-		return false;
+		menu_buttons_[i] = std::make_unique<Button>(game_, font_);
+		menu_buttons_[i]->SetText(menu_texts[i]);
 	}
 
-	return InitTextures();
+	// Decoding and text rasterization happen on a worker; Render uploads the results once they
+	// are ready and draws an empty menu until then.
+	pending_assets_ = std::async(std::launch::async, &MenuState::LoadAssets, game_->UiScale(), menu_texts);
+
+	return true;
 }
 
 void MenuState::Exit()
 {
+	if (pending_assets_.valid())
+	{
+		MenuAssets assets = pending_assets_.get();
+		FreeAssets(&assets);
+	}
+
 	TTF_CloseFont(font_);
 	font_ = nullptr;
 
@@ -46,38 +70,139 @@ void MenuState::Exit()
 	}
 }
 
-bool MenuState::InitTextures()
+MenuAssets MenuState::LoadAssets(double ui_scale, std::vector<std::string> texts)
 {
-	title_texture_ = std::make_unique<Texture>();
+	MenuAssets assets = { nullptr, nullptr, {} };
+
+	assets.title_surface_ = AssetPack::Instance().LoadSurface("gfx/title.png");
+	assets.font_ = AssetPack::Instance().OpenFont("font/font.ttf", std::max(1, static_cast<int>(58 * ui_scale)));
 
-	if (!title_texture_->LoadFromPath(game_->GetRenderer(), "res/gfx/title.png"))
+	if (assets.font_ == nullptr)
+	{
+		printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
+		return assets;
+	}
+
+	for (const std::string& text : texts)
+	{
+		assets.label_surfaces_.push_back(TTF_RenderText_Blended(assets.font_, text.c_str(), { 0x00, 0x00, 0x00, 0xFF }));
+	}
+
+	return assets;
+}
+
+void MenuState::FreeAssets(MenuAssets* assets)
+{
+	SDL_FreeSurface(assets->title_surface_);
+	assets->title_surface_ = nullptr;
+
+	TTF_CloseFont(assets->font_);
+	assets->font_ = nullptr;
+
+	for (SDL_Surface* label_surface : assets->label_surfaces_)
+	{
+		SDL_FreeSurface(label_surface);
+	}
+
+	assets->label_surfaces_.clear();
+}
+
+bool MenuState::FinishLoading()
+{
+	game_->AllowFrameAllocations();
+
+	MenuAssets assets = pending_assets_.get();
+	bool loaded = assets.title_surface_ != nullptr && title_texture_->LoadFromSurface(game_->GetRenderer(), assets.title_surface_);
+
+	if (!loaded)
 	{
 		printf("Failed to load title texture!\n");
+	}
+
+	for (std::size_t i = 0; loaded && i < menu_buttons_.size(); ++i)
+	{
+		loaded = i < assets.label_surfaces_.size() && assets.label_surfaces_[i] != nullptr && 
+			menu_buttons_[i]->LoadFromSurface(assets.label_surfaces_[i]);
+	}
+
+	font_ = assets.font_;
+	assets.font_ = nullptr;
+	FreeAssets(&assets);
+
+	if (!loaded)
+	{
 		return false;
 	}
 
-	const std::vector<std::string> menu_texts = { "Singleplayer", "Multiplayer" };
-	const int button_height = 400;
+	for (const std::unique_ptr<Button>& button : menu_buttons_)
+	{
+		button->SetFont(font_);
+		button->SetReload(false);
+	}
+
+	PositionElements();
 
-	menu_buttons_.resize(2);
+	tweens_.Release(&transition_tween_);
+	transition_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::transition_seconds), Easing::EASE_IN_OUT);
 
-	for (std::size_t i = 0; i < menu_texts.size(); ++i)
+	assets_ready_ = true;
+
+	return true;
+}
+
+bool MenuState::Layout()
+{
+	game_->AllowFrameAllocations();
+
+	TTF_Font* font = AssetPack::Instance().OpenFont("font/font.ttf", std::max(1, static_cast<int>(58 * game_->UiScale())));
+
+	if (font == nullptr)
 	{
-		menu_buttons_[i] = std::make_unique<Button>(game_, font_);
-		menu_buttons_[i]->SetText(menu_texts[i].c_str());
-		menu_buttons_[i]->Tick(true);
-		menu_buttons_[i]->SetPosition((constants::screen_width / 2) - (menu_buttons_[i]->GetTexture()->Width() / 2), button_height + i * 100);
+		printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
+		return false;
+	}
+
+	TTF_CloseFont(font_);
+	font_ = font;
+
+	for (const std::unique_ptr<Button>& button : menu_buttons_)
+	{
+		button->SetFont(font_);
+		button->Tick(true);
 	}
 
+	PositionElements();
+
 	return true;
 }
 
+void MenuState::PositionElements()
+{
+	const double ui_scale = game_->UiScale();
+
+	title_scale_ = 6.0 * ui_scale;
+	title_y_ = static_cast<int>(200 * ui_scale);
+
+	const int button_y = static_cast<int>(400 * ui_scale);
+	const int button_spacing = static_cast<int>(100 * ui_scale);
+
+	for (std::size_t i = 0; i < menu_buttons_.size(); ++i)
+	{
+		menu_buttons_[i]->SetPosition((game_->ScreenWidth() / 2) - (menu_buttons_[i]->GetTexture()->Width() / 2), button_y + static_cast<int>(i) * button_spacing);
+	}
+}
+
 void MenuState::Pause()
 {
 }
 	
 void MenuState::Resume()
 {
+	tweens_.Release(&transition_tween_);
+	transition_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::transition_seconds), Easing::EASE_IN_OUT);
+
+	// The window may have been resized while the board was on top.
+	Layout();
 }
 
 void MenuState::HandleEvents()
@@ -90,8 +215,22 @@ void MenuState::HandleEvents()
 		{
 			game_->Stop();
 		}
-		else if (e.type == SDL_MOUSEBUTTONUP || e.type == SDL_MOUSEMOTION)
+		else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
 		{
+			game_->UpdateScreenSize();
+
+			if (assets_ready_)
+			{
+				Layout();
+			}
+		}
+		else if (assets_ready_ && (e.type == SDL_MOUSEBUTTONUP || e.type == SDL_MOUSEMOTION))
+		{
+			if (e.type == SDL_MOUSEBUTTONUP)
+			{
+				game_->GetInputLatency()->Consumed(game_->GetInputLatency()->Stamp());
+			}
+
 			for (const std::unique_ptr<Button>& button : menu_buttons_)
 			{
 				button->HandleEvent(&e);
@@ -102,13 +241,20 @@ void MenuState::HandleEvents()
 
 void MenuState::Tick()
 {
+	tweens_.Update();
+
+	if (!assets_ready_)
+	{
+		return;
+	}
+
 	for (const std::unique_ptr<Button>& button : menu_buttons_)
 	{
 		button->Tick();
 	}
 }
 
-void MenuState::Render()
+void MenuState::Render(double alpha)
 {
 	SDL_Renderer* renderer = game_->GetRenderer();
 
@@ -116,17 +262,39 @@ void MenuState::Render()
 	SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 	SDL_RenderClear(renderer);
 
-	SDL_Rect src = { 0, 0, title_texture_->Width(), title_texture_->Height() };
+	const bool first_menu_frame = !assets_ready_;
 
-	const int title_height = 200;
-	constexpr double scale = 6.0;
+	if (!assets_ready_)
+	{
+		if (pending_assets_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			SDL_RenderPresent(renderer);
+			return;
+		}
+
+		if (!FinishLoading())
+		{
+			game_->Stop();
+			return;
+		}
+	}
 
-	title_texture_->Render(renderer, (constants::screen_width / 2) - ((title_texture_->Width() * scale) / 2), title_height, &src, scale);
+	SDL_Rect src = { 0, 0, title_texture_->Width(), title_texture_->Height() };
+
+	title_texture_->Render(renderer, (game_->ScreenWidth() / 2) - ((title_texture_->Width() * title_scale_) / 2), title_y_, &src, title_scale_);
 
 	for (const std::unique_ptr<Button>& button : menu_buttons_)
 	{
 		button->Render(renderer);
 	}
 
+	RenderTransition(renderer, tweens_.Value(transition_tween_, static_cast<float>(alpha)));
+
 	SDL_RenderPresent(renderer);
+	game_->GetInputLatency()->Presented();
+
+	if (first_menu_frame)
+	{
+		game_->MarkStartup("menu presented");
+	}
 }
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "AI/Position.hpp"
+#include "AI/Qubic.hpp"
+#include "States/QubicState.hpp"
+#include "Utils/Constants.hpp"
+#include "Utils/Metrics.hpp"
+#include "AiJobs.hpp"
+#include "Game.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+	// Interpolated between ticks, like the snapshot fades on the 3x3 board.
+	float Fade(int elapsed_ticks, int duration_ticks, double alpha)
+	{
+		return std::clamp(static_cast<float>(elapsed_ticks + alpha) / duration_ticks, 0.0f, 1.0f);
+	}
+} // namespace
+
+std::unique_ptr<QubicState> QubicState::qubic_state_ = std::make_unique<QubicState>();
+
+QubicState* QubicState::Instance()
+{
+	return qubic_state_.get();
+}
+
+bool QubicState::Enter(Game* game)
+{
+	game_ = game;
+	tick_ = 0;
+	first_symbol_ = CellSymbol::O;
+
+	tweens_.Clear();
+	transition_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::transition_seconds), Easing::EASE_IN_OUT);
+
+	if (search_ == nullptr)
+	{
+		search_ = std::make_unique<QubicSearch>();
+	}
+
+	jobs_.Attach(game_);
+
+	if (!symbols_sheet_.Load("gfx/symbols.png", 2))
+	{
+		printf("Failed to load symbols texture!\n");
+		return false;
+	}
+
+	Layout();
+	NewGame();
+
+	return true;
+}
+
+void QubicState::Exit()
+{
+	StopThinking();
+
+	symbols_sheet_.Free();
+}
+
+void QubicState::Layout()
+{
+	game_->AllowFrameAllocations();
+
+	const int width = game_->ScreenWidth();
+	const int height = game_->ScreenHeight();
+
+	const int separator_width = std::max(1, static_cast<int>(6 * game_->UiScale()));
+	const int layer_gap = std::max(2, static_cast<int>(24 * game_->UiScale()));
+
+	// Layers are stacked top (layer 0) to bottom, each a 4x4 grid.
+	const int layer_side = std::max(4, std::min(width - 2 * layer_gap, (height - (qubic::side + 1) * layer_gap) / qubic::side));
+
+	cell_side_ = std::max(1, (layer_side - (qubic::side - 1) * separator_width) / qubic::side);
+
+	const int grid_side = qubic::side * cell_side_ + (qubic::side - 1) * separator_width;
+	const int stack_height = qubic::side * grid_side + (qubic::side - 1) * layer_gap;
+	const int grid_x = (width - grid_side) / 2;
+	const int grid_y = (height - stack_height) / 2;
+
+	for (int i = 0; i < qubic::n_cells; ++i)
+	{
+		const int layer = i / 16;
+
+		cell_rects_[i].x = grid_x + (i % 4) * (cell_side_ + separator_width);
+		cell_rects_[i].y = grid_y + layer * (grid_side + layer_gap) + (i / 4 % 4) * (cell_side_ + separator_width);
+		cell_rects_[i].w = cell_side_;
+		cell_rects_[i].h = cell_side_;
+	}
+
+	symbols_sheet_.ClearCache();
+}
+
+void QubicState::Pause()
+{
+}
+
+void QubicState::Resume()
+{
+}
+
+void QubicState::HandleEvents()
+{
+	SDL_Event e;
+
+	while (SDL_PollEvent(&e) != 0)
+	{
+		if (e.type == SDL_QUIT)
+		{
+			game_->Stop();
+		}
+		else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+		{
+			game_->UpdateScreenSize();
+			Layout();
+		}
+		else if (e.type == SDL_MOUSEBUTTONDOWN)
+		{
+			const InputStamp stamp = game_->GetInputLatency()->Stamp();
+			game_->GetInputLatency()->Consumed(stamp);
+
+			if (over_)
+			{
+				NewGame();
+				continue;
+			}
+
+			int x = e.button.x;
+			int y = e.button.y;
+			game_->WindowToRenderer(&x, &y);
+
+			const int cell = CellAt(x, y);
+
+			if (cell >= 0 && !awaiting_move_ && position_.SideToMove() == CellSymbol::X && position_.At(cell) == CellSymbol::EMPTY)
+			{
+				PlayMove(static_cast<std::size_t>(cell), stamp.counter_);
+			}
+		}
+		else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_m)
+		{
+			game_->GetInputLatency()->Consumed(game_->GetInputLatency()->Stamp());
+			game_->SetGameMode(GameMode::NONE);
+			game_->PopState();
+		}
+	}
+}
+
+void QubicState::Tick()
+{
+	tweens_.Update();
+	++tick_;
+
+	if (jobs_.Running() || over_)
+	{
+		return;
+	}
+
+	if (awaiting_move_)
+	{
+		awaiting_move_ = false;
+		Metrics::Instance().AiMoveLatency().Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - think_start_).count());
+		PlayMove(static_cast<std::size_t>(chosen_move_));
+	}
+	else if (position_.SideToMove() == CellSymbol::O)
+	{
+		StartThinking();
+	}
+}
+
+void QubicState::Render(double alpha)
+{
+	SDL_Renderer* renderer = game_->GetRenderer();
+
+	SDL_RenderSetViewport(renderer, NULL);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+	SDL_RenderClear(renderer);
+
+	Texture* symbols_texture = symbols_sheet_.Get(renderer, cell_side_);
+	const float win_fade = Fade(tick_ - win_tick_, game_->SecondsToTicks(constants::win_sweep_seconds), alpha);
+
+	for (int i = 0; i < qubic::n_cells; ++i)
+	{
+		const SDL_Rect& cell_rect = cell_rects_[i];
+
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderFillRect(renderer, &cell_rect);
+
+		if ((win_cells_ >> i) & 1)
+		{
+			SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+			SDL_SetRenderDrawColor(renderer, 0x00, 0xB4, 0x00, static_cast<Uint8>(win_fade * 0xFF));
+			SDL_RenderFillRect(renderer, &cell_rect);
+			SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+		}
+
+		const CellSymbol symbol = position_.At(i);
+
+		if (symbol != CellSymbol::EMPTY && symbols_texture != nullptr)
+		{
+			SDL_Rect symbol_clip = symbols_sheet_.Clip(symbol == CellSymbol::X, cell_side_);
+			const float symbol_fade = Fade(tick_ - placed_tick_[i], game_->SecondsToTicks(constants::symbol_fade_seconds), alpha);
+
+			symbols_texture->SetAlpha(static_cast<Uint8>(symbol_fade * 0xFF));
+			symbols_texture->Render(renderer, cell_rect.x, cell_rect.y, &symbol_clip, 1.0);
+			symbols_texture->SetAlpha(0xFF);
+		}
+	}
+
+	RenderTransition(renderer, tweens_.Value(transition_tween_, static_cast<float>(alpha)));
+
+	SDL_RenderPresent(renderer);
+	game_->GetInputLatency()->Presented();
+}
+
+void QubicState::NewGame()
+{
+	StopThinking();
+
+	// The first move is worth a lot in Qubic, so the human and the AI take turns having it.
+	first_symbol_ = Position::Opponent(first_symbol_);
+
+	position_.Reset(first_symbol_);
+	placed_tick_.fill(0);
+	win_cells_ = 0;
+	win_tick_ = 0;
+	over_ = false;
+}
+
+void QubicState::PlayMove(std::size_t index, std::uint64_t click_counter)
+{
+	if (index >= static_cast<std::size_t>(qubic::n_cells) || position_.At(index) != CellSymbol::EMPTY)
+	{
+		return;
+	}
+
+	position_.MakeMove(index);
+	placed_tick_[index] = tick_;
+
+	win_cells_ = position_.WinningLines(index);
+
+	if (win_cells_ != 0)
+	{
+		win_tick_ = tick_;
+		over_ = true;
+		game_->GetAudio()->Play(Sound::WIN, click_counter);
+	}
+	else if (position_.FreeCells() == 0)
+	{
+		over_ = true;
+		game_->GetAudio()->Play(Sound::TIE, click_counter);
+	}
+	else
+	{
+		game_->GetAudio()->Play(Sound::PLACE, click_counter);
+	}
+}
+
+int QubicState::CellAt(int x, int y) const
+{
+	const SDL_Point mouse_position = { x, y };
+
+	for (int i = 0; i < qubic::n_cells; ++i)
+	{
+		if (SDL_PointInRect(&mouse_position, &cell_rects_[i]))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void QubicState::StartThinking()
+{
+	awaiting_move_ = true;
+	think_start_ = std::chrono::steady_clock::now();
+
+	search_->SetDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(constants::qubic_think_milliseconds));
+
+	jobs_.Submit([this](std::size_t)
+	{
+		chosen_move_ = search_->Run(position_, constants::qubic_max_depth).best_move_;
+	});
+}
+
+void QubicState::StopThinking()
+{
+	jobs_.Stop(std::array{ search_.get() });
+
+	awaiting_move_ = false;
+}
@@ -0,0 +1,401 @@
+#include "AI/Position.hpp"
+#include "AI/Ultimate.hpp"
+#include "States/UltimateState.hpp"
+#include "Utils/Constants.hpp"
+#include "Utils/Metrics.hpp"
+#include "AiJobs.hpp"
+#include "Game.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <memory>
+
+namespace
+{
+	// Interpolated between ticks, like the snapshot fades on the 3x3 board.
+	float Fade(int elapsed_ticks, int duration_ticks, double alpha)
+	{
+		return std::clamp(static_cast<float>(elapsed_ticks + alpha) / duration_ticks, 0.0f, 1.0f);
+	}
+
+	void FillRect(SDL_Renderer* renderer, const SDL_Rect& rect, const SDL_Color& colour)
+	{
+		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+		SDL_SetRenderDrawColor(renderer, colour.r, colour.g, colour.b, colour.a);
+		SDL_RenderFillRect(renderer, &rect);
+		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	}
+} // namespace
+
+std::unique_ptr<UltimateState> UltimateState::ultimate_state_ = std::make_unique<UltimateState>();
+
+UltimateState* UltimateState::Instance()
+{
+	return ultimate_state_.get();
+}
+
+bool UltimateState::Enter(Game* game)
+{
+	game_ = game;
+	tick_ = 0;
+	first_symbol_ = CellSymbol::O;
+
+	tweens_.Clear();
+	transition_tween_ = tweens_.Start(0.0f, 1.0f, game_->SecondsToTicks(constants::transition_seconds), Easing::EASE_IN_OUT);
+
+	jobs_.Attach(game_);
+
+	if (searches_.empty())
+	{
+		for (std::size_t i = 0; i < jobs_.Workers(); ++i)
+		{
+			searches_.push_back(std::make_unique<UltimateSearch>(constants::ultimate_mcts_nodes, i + 1));
+		}
+	}
+
+	if (!symbols_sheet_.Load("gfx/symbols.png", 2))
+	{
+		printf("Failed to load symbols texture!\n");
+		return false;
+	}
+
+	Layout();
+	NewGame();
+
+	return true;
+}
+
+void UltimateState::Exit()
+{
+	StopThinking();
+
+	symbols_sheet_.Free();
+}
+
+void UltimateState::Layout()
+{
+	game_->AllowFrameAllocations();
+
+	const int width = game_->ScreenWidth();
+	const int height = game_->ScreenHeight();
+
+	// The board layout of the 3x3 game, nested: boards are spaced like the cells there and each
+	// board's cells are spaced more tightly.
+	const int board_gap = std::max(3, static_cast<int>(15 * game_->UiScale()));
+	const int cell_gap = std::max(1, static_cast<int>(4 * game_->UiScale()));
+	const int grid_side = std::max(9, std::min(width, height) - 2 * board_gap);
+
+	cell_side_ = std::max(1, ((grid_side - 2 * board_gap) / 3 - 2 * cell_gap) / 3);
+	board_side_ = 3 * cell_side_ + 2 * cell_gap;
+	highlight_width_ = std::max(1, board_gap / 3);
+
+	const int total_side = 3 * board_side_ + 2 * board_gap;
+	const int grid_x = (width - total_side) / 2;
+	const int grid_y = (height - total_side) / 2;
+
+	for (int board = 0; board < ultimate::n_boards; ++board)
+	{
+		board_rects_[board] = {
+			grid_x + (board % 3) * (board_side_ + board_gap),
+			grid_y + (board / 3) * (board_side_ + board_gap),
+			board_side_,
+			board_side_
+		};
+
+		for (int cell = 0; cell < 9; ++cell)
+		{
+			cell_rects_[board * 9 + cell] = {
+				board_rects_[board].x + (cell % 3) * (cell_side_ + cell_gap),
+				board_rects_[board].y + (cell / 3) * (cell_side_ + cell_gap),
+				cell_side_,
+				cell_side_
+			};
+		}
+	}
+
+	symbols_sheet_.ClearCache();
+}
+
+void UltimateState::Pause()
+{
+}
+
+void UltimateState::Resume()
+{
+}
+
+void UltimateState::HandleEvents()
+{
+	SDL_Event e;
+
+	while (SDL_PollEvent(&e) != 0)
+	{
+		if (e.type == SDL_QUIT)
+		{
+			game_->Stop();
+		}
+		else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+		{
+			game_->UpdateScreenSize();
+			Layout();
+		}
+		else if (e.type == SDL_MOUSEBUTTONDOWN)
+		{
+			const InputStamp stamp = game_->GetInputLatency()->Stamp();
+			game_->GetInputLatency()->Consumed(stamp);
+
+			if (over_)
+			{
+				NewGame();
+				continue;
+			}
+
+			int x = e.button.x;
+			int y = e.button.y;
+			game_->WindowToRenderer(&x, &y);
+
+			const int move = CellAt(x, y);
+
+			if (!awaiting_move_ && position_.SideToMove() == CellSymbol::X && position_.IsLegal(move))
+			{
+				PlayMove(move, stamp.counter_);
+			}
+		}
+		else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_m)
+		{
+			game_->GetInputLatency()->Consumed(game_->GetInputLatency()->Stamp());
+			game_->SetGameMode(GameMode::NONE);
+			game_->PopState();
+		}
+	}
+}
+
+void UltimateState::Tick()
+{
+	tweens_.Update();
+	++tick_;
+
+	if (jobs_.Running() || over_)
+	{
+		return;
+	}
+
+	if (awaiting_move_)
+	{
+		awaiting_move_ = false;
+		Metrics::Instance().AiMoveLatency().Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - think_start_).count());
+		PlayMove(ChosenMove());
+	}
+	else if (position_.SideToMove() == CellSymbol::O)
+	{
+		StartThinking();
+	}
+}
+
+void UltimateState::Render(double alpha)
+{
+	SDL_Renderer* renderer = game_->GetRenderer();
+
+	SDL_RenderSetViewport(renderer, NULL);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+	SDL_RenderClear(renderer);
+
+	Texture* cell_symbols = symbols_sheet_.Get(renderer, cell_side_);
+	Texture* board_symbols = symbols_sheet_.Get(renderer, board_side_);
+
+	for (int board = 0; board < ultimate::n_boards; ++board)
+	{
+		const SDL_Rect& board_rect = board_rects_[board];
+
+		// Frames the boards the next move may go to.
+		if (!over_ && position_.OpenCells(board) != 0 && (position_.NextBoard() == -1 || position_.NextBoard() == board))
+		{
+			const SDL_Rect frame_rect = { board_rect.x - highlight_width_, board_rect.y - highlight_width_, board_rect.w + 2 * highlight_width_, board_rect.h + 2 * highlight_width_ };
+
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xC8, 0x00, 0xFF);
+			SDL_RenderFillRect(renderer, &frame_rect);
+			SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+			SDL_RenderFillRect(renderer, &board_rect);
+		}
+
+		for (int cell = 0; cell < 9; ++cell)
+		{
+			const int move = board * 9 + cell;
+			const SDL_Rect& cell_rect = cell_rects_[move];
+
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			SDL_RenderFillRect(renderer, &cell_rect);
+
+			const CellSymbol symbol = position_.At(move);
+
+			if (symbol != CellSymbol::EMPTY && cell_symbols != nullptr)
+			{
+				SDL_Rect symbol_clip = symbols_sheet_.Clip(symbol == CellSymbol::X, cell_side_);
+
+				cell_symbols->SetAlpha(static_cast<Uint8>(Fade(tick_ - placed_tick_[move], game_->SecondsToTicks(constants::symbol_fade_seconds), alpha) * 0xFF));
+				cell_symbols->Render(renderer, cell_rect.x, cell_rect.y, &symbol_clip, 1.0);
+				cell_symbols->SetAlpha(0xFF);
+			}
+		}
+
+		// A won board fades to its winner's symbol drawn across the whole board.
+		const CellSymbol board_winner = position_.BoardWinner(board);
+
+		if (board_winner != CellSymbol::EMPTY)
+		{
+			const float board_fade = Fade(tick_ - board_won_tick_[board], game_->SecondsToTicks(constants::symbol_fade_seconds), alpha);
+
+			FillRect(renderer, board_rect, { 0xFF, 0xFF, 0xFF, static_cast<Uint8>(board_fade * 0xC0) });
+
+			if (board_symbols != nullptr)
+			{
+				SDL_Rect symbol_clip = symbols_sheet_.Clip(board_winner == CellSymbol::X, board_side_);
+
+				board_symbols->SetAlpha(static_cast<Uint8>(board_fade * 0xFF));
+				board_symbols->Render(renderer, board_rect.x, board_rect.y, &symbol_clip, 1.0);
+				board_symbols->SetAlpha(0xFF);
+			}
+		}
+
+		if ((winning_boards_ >> board) & 1)
+		{
+			FillRect(renderer, board_rect, { 0x00, 0xB4, 0x00, static_cast<Uint8>(Fade(tick_ - win_tick_, game_->SecondsToTicks(constants::win_sweep_seconds), alpha) * 0x90) });
+		}
+	}
+
+	RenderTransition(renderer, tweens_.Value(transition_tween_, static_cast<float>(alpha)));
+
+	SDL_RenderPresent(renderer);
+	game_->GetInputLatency()->Presented();
+}
+
+void UltimateState::NewGame()
+{
+	StopThinking();
+
+	// Take turns having the first move, as in Qubic.
+	first_symbol_ = Position::Opponent(first_symbol_);
+
+	position_.Reset(first_symbol_);
+	placed_tick_.fill(0);
+	board_won_tick_.fill(0);
+	winning_boards_ = 0;
+	win_tick_ = 0;
+	over_ = false;
+}
+
+void UltimateState::PlayMove(int move, std::uint64_t click_counter)
+{
+	if (!position_.IsLegal(move))
+	{
+		return;
+	}
+
+	const int board = move / 9;
+	const CellSymbol board_winner = position_.BoardWinner(board);
+
+	position_.MakeMove(move);
+	placed_tick_[move] = tick_;
+
+	if (position_.BoardWinner(board) != board_winner)
+	{
+		board_won_tick_[board] = tick_;
+	}
+
+	if (!position_.IsOver())
+	{
+		game_->GetAudio()->Play(Sound::PLACE, click_counter);
+		return;
+	}
+
+	over_ = true;
+	game_->GetAudio()->Play(position_.Winner() != CellSymbol::EMPTY ? Sound::WIN : Sound::TIE, click_counter);
+
+	if (position_.Winner() != CellSymbol::EMPTY)
+	{
+		const std::uint16_t boards_won = position_.BoardsWon(position_.Winner());
+
+		for (const std::uint16_t line : ultimate::lines)
+		{
+			if ((boards_won & line) == line)
+			{
+				winning_boards_ |= line;
+			}
+		}
+
+		win_tick_ = tick_;
+	}
+}
+
+int UltimateState::CellAt(int x, int y) const
+{
+	const SDL_Point mouse_position = { x, y };
+
+	for (int i = 0; i < ultimate::n_moves; ++i)
+	{
+		if (SDL_PointInRect(&mouse_position, &cell_rects_[i]))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void UltimateState::StartThinking()
+{
+	awaiting_move_ = true;
+	think_start_ = std::chrono::steady_clock::now();
+
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(constants::ultimate_think_milliseconds);
+
+	for (const std::unique_ptr<UltimateSearch>& search : searches_)
+	{
+		search->SetDeadline(deadline);
+	}
+
+	// One job per search rather than per worker index: a worker that picks up two jobs runs them
+	// back to back and the second one ends at the shared deadline.
+	for (std::size_t i = 0; i < searches_.size(); ++i)
+	{
+		jobs_.Submit([this, i](std::size_t)
+		{
+			searches_[i]->Run(position_, std::numeric_limits<std::uint64_t>::max());
+		});
+	}
+}
+
+void UltimateState::StopThinking()
+{
+	jobs_.Stop(searches_);
+
+	awaiting_move_ = false;
+}
+
+int UltimateState::ChosenMove() const
+{
+	int chosen_move = -1;
+	std::uint64_t chosen_visits = 0;
+
+	for (int move = 0; move < ultimate::n_moves; ++move)
+	{
+		std::uint64_t visits = 0;
+
+		for (const std::unique_ptr<UltimateSearch>& search : searches_)
+		{
+			visits += search->RootVisits()[move];
+		}
+
+		if (position_.IsLegal(move) && (chosen_move == -1 || visits > chosen_visits))
+		{
+			chosen_move = move;
+			chosen_visits = visits;
+		}
+	}
+
+	return chosen_move;
+}
@@ -1,7 +1,7 @@
 #include "Texture.hpp"
+#include "Utils/Metrics.hpp"
 
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 
 #include <iostream>
@@ -26,37 +26,24 @@ void Texture::FreeTexture()
 	}
 }
 
-bool Texture::LoadFromPath(SDL_Renderer* renderer, const char* path)
+bool Texture::LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface)
 {
 	FreeTexture();
 
-	SDL_Texture* tmp_texture = nullptr;
-	SDL_Surface* loaded_surface = IMG_Load(path);
+	texture_ = SDL_CreateTextureFromSurface(renderer, surface);
 
-	if (loaded_surface == nullptr)
+	if (texture_ == nullptr)
 	{
-		printf("Unable to load image %s! SDL_image Error: %s\n", path, IMG_GetError());
+		printf("Unable to create texture from surface! SDL Error: %s\n", SDL_GetError());
 		return false;
 	}
 
-	SDL_SetColorKey(loaded_surface, SDL_TRUE, SDL_MapRGB(loaded_surface->format, 0xFF, 0x00, 0xFF));
-
-	tmp_texture = SDL_CreateTextureFromSurface(renderer, loaded_surface);
-
-	if (tmp_texture == nullptr)
-	{
-		printf("Unable to create texture from %s! SDL Error: %s\n", path, SDL_GetError());
-	}
-	else
-	{
-		width_ = loaded_surface->w;
-		height_ = loaded_surface->h;
-	}
+	Metrics::Instance().TextureUploads().Add();
 
-	SDL_FreeSurface(loaded_surface);
-	texture_ = tmp_texture;
+	width_ = surface->w;
+	height_ = surface->h;
 
-	return texture_ != nullptr;
+	return true;
 }
 
 bool Texture::LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* text, const SDL_Color& text_color)
@@ -80,6 +67,8 @@ bool Texture::LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* t
 		return false;
 	}
 
+	Metrics::Instance().TextureUploads().Add();
+
 	width_ = text_surface->w;	
 	height_ = text_surface->h;	
 	SDL_FreeSurface(text_surface);
@@ -100,6 +89,11 @@ void Texture::Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip, doubl
 	SDL_RenderCopy(renderer, texture_, clip, &renderQuad);
 }
 
+void Texture::SetAlpha(Uint8 alpha)
+{
+	SDL_SetTextureAlphaMod(texture_, alpha);
+}
+
 int Texture::Width() const
 {
 	return width_;
@@ -0,0 +1,186 @@
+#include "Utils/AllocationTracker.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// Plain zero-initialized thread_locals: no constructor runs, so they are safe to touch from
+	// the very first allocation of a thread.
+	thread_local std::uint64_t thread_allocations = 0;
+	thread_local std::uint64_t thread_bytes = 0;
+
+	std::atomic<bool> strict(false);
+
+	void* Allocate(std::size_t size)
+	{
+		++thread_allocations;
+		thread_bytes += size;
+
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		++thread_allocations;
+		thread_bytes += size;
+
+		const std::size_t align = static_cast<std::size_t>(alignment);
+
+		return std::aligned_alloc(align, (size + align - 1) / align * align);
+	}
+
+	void* AllocateOrThrow(std::size_t size)
+	{
+		void* pointer = Allocate(size);
+
+		if (pointer == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return pointer;
+	}
+
+	void* AllocateAlignedOrThrow(std::size_t size, std::align_val_t alignment)
+	{
+		void* pointer = AllocateAligned(size, alignment);
+
+		if (pointer == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return pointer;
+	}
+} // namespace
+
+AllocationStats AllocationTracker::ThreadTotals()
+{
+	return { thread_allocations, thread_bytes };
+}
+
+void AllocationTracker::SetStrict(bool strict_mode)
+{
+	strict = strict_mode;
+}
+
+bool AllocationTracker::Strict()
+{
+	return strict;
+}
+
+void AllocationTracker::ExpectNone(const char* what, const AllocationStats& stats)
+{
+	if (strict && stats.allocations_ != 0)
+	{
+		fprintf(stderr, "Allocation check failed: %s made %llu allocations (%llu bytes)\n", what, 
+			static_cast<unsigned long long>(stats.allocations_), static_cast<unsigned long long>(stats.bytes_));
+		assert(stats.allocations_ == 0);
+	}
+}
+
+AllocationScope::AllocationScope() : start_(AllocationTracker::ThreadTotals())
+{
+}
+
+AllocationStats AllocationScope::Stats() const
+{
+	const AllocationStats now = AllocationTracker::ThreadTotals();
+
+	return { now.allocations_ - start_.allocations_, now.bytes_ - start_.bytes_ };
+}
+
+void* operator new(std::size_t size)
+{
+	return AllocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return AllocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return AllocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return AllocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	std::free(pointer);
+}
@@ -0,0 +1,321 @@
+#include "Utils/AssetPack.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+AssetPack::AssetPack() : data_(nullptr), size_(0), entries_(nullptr), n_entries_(0)
+{
+	char* base_path = SDL_GetBasePath();
+
+	if (base_path != nullptr)
+	{
+		base_path_ = base_path;
+		SDL_free(base_path);
+	}
+}
+
+AssetPack::~AssetPack()
+{
+	Unmount();
+}
+
+AssetPack& AssetPack::Instance()
+{
+	static AssetPack asset_pack;
+	return asset_pack;
+}
+
+bool AssetPack::Mount(const char* pack_name)
+{
+	Unmount();
+
+	const std::string path = base_path_ + pack_name;
+	const int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+	{
+		printf("Asset pack %s not found, loading assets from res/\n", path.c_str());
+		return false;
+	}
+
+	struct stat file_stat;
+
+	if (fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(Header))
+	{
+		close(fd);
+		return false;
+	}
+
+	void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+	{
+		printf("Unable to map asset pack %s!\n", path.c_str());
+		return false;
+	}
+
+	// The whole pack is needed during startup, so fault it in with one read-ahead.
+	madvise(mapping, file_stat.st_size, MADV_WILLNEED);
+
+	data_ = static_cast<const unsigned char*>(mapping);
+	size_ = file_stat.st_size;
+
+	const Header* header = reinterpret_cast<const Header*>(data_);
+
+	if (std::memcmp(header->magic_, magic, sizeof(magic)) != 0 || sizeof(Header) + header->n_entries_ * sizeof(Entry) > size_)
+	{
+		printf("Asset pack %s is invalid!\n", path.c_str());
+		Unmount();
+		return false;
+	}
+
+	entries_ = reinterpret_cast<const Entry*>(data_ + sizeof(Header));
+	n_entries_ = header->n_entries_;
+
+	for (std::uint32_t i = 0; i < n_entries_; ++i)
+	{
+		if (entries_[i].offset_ > size_ || entries_[i].size_ > size_ - entries_[i].offset_)
+		{
+			printf("Asset pack %s is truncated!\n", path.c_str());
+			Unmount();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void AssetPack::Unmount()
+{
+	if (data_ != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(data_), size_);
+	}
+
+	data_ = nullptr;
+	size_ = 0;
+	entries_ = nullptr;
+	n_entries_ = 0;
+}
+
+bool AssetPack::Mounted() const
+{
+	return data_ != nullptr;
+}
+
+const AssetPack::Entry* AssetPack::Find(const char* name) const
+{
+	for (std::uint32_t i = 0; i < n_entries_; ++i)
+	{
+		if (std::strncmp(entries_[i].name_, name, sizeof(entries_[i].name_)) == 0)
+		{
+			return &entries_[i];
+		}
+	}
+
+	return nullptr;
+}
+
+SDL_Surface* AssetPack::LoadSurface(const char* name) const
+{
+	const Entry* entry = Find(name);
+
+	if (entry == nullptr || entry->type_ != EntryType::PIXELS)
+	{
+		return DecodeImage((base_path_ + "res/" + name).c_str());
+	}
+
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<unsigned char*>(data_ + entry->offset_), 
+		entry->width_, entry->height_, 32, entry->pitch_, SDL_PIXELFORMAT_RGBA32);
+
+	if (surface == nullptr)
+	{
+		printf("Unable to create surface for %s! SDL Error: %s\n", name, SDL_GetError());
+	}
+
+	return surface;
+}
+
+TTF_Font* AssetPack::OpenFont(const char* name, int point_size) const
+{
+	const Entry* entry = Find(name);
+
+	if (entry == nullptr)
+	{
+		return TTF_OpenFont((base_path_ + "res/" + name).c_str(), point_size);
+	}
+
+	return TTF_OpenFontRW(SDL_RWFromConstMem(data_ + entry->offset_, static_cast<int>(entry->size_)), 1, point_size);
+}
+
+Mix_Chunk* AssetPack::LoadChunk(const char* name) const
+{
+	const Entry* entry = Find(name);
+
+	if (entry == nullptr)
+	{
+		return Mix_LoadWAV((base_path_ + "res/" + name).c_str());
+	}
+
+	return Mix_LoadWAV_RW(SDL_RWFromConstMem(data_ + entry->offset_, static_cast<int>(entry->size_)), 1);
+}
+
+SDL_Surface* AssetPack::DecodeImage(const char* path)
+{
+	SDL_Surface* loaded_surface = IMG_Load(path);
+
+	if (loaded_surface == nullptr)
+	{
+		printf("Unable to load image %s! SDL_image Error: %s\n", path, IMG_GetError());
+		return nullptr;
+	}
+
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded_surface, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(loaded_surface);
+
+	if (surface == nullptr)
+	{
+		printf("Unable to convert image %s! SDL Error: %s\n", path, SDL_GetError());
+		return nullptr;
+	}
+
+	// The sprites use magenta as their color key; turn it into real transparency.
+	for (int y = 0; y < surface->h; ++y)
+	{
+		Uint8* row = static_cast<Uint8*>(surface->pixels) + y * surface->pitch;
+
+		for (int x = 0; x < surface->w; ++x)
+		{
+			Uint8* pixel = row + x * 4;
+
+			if (pixel[0] == 0xFF && pixel[1] == 0x00 && pixel[2] == 0xFF)
+			{
+				pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+			}
+		}
+	}
+
+	return surface;
+}
+
+bool AssetPack::Build(const char* res_dir, const char* output_path)
+{
+	std::vector<std::filesystem::path> files;
+	std::error_code error;
+
+	for (const std::filesystem::directory_entry& file : std::filesystem::recursive_directory_iterator(res_dir, error))
+	{
+		if (file.is_regular_file())
+		{
+			files.push_back(file.path());
+		}
+	}
+
+	if (error || files.empty())
+	{
+		printf("No assets found in %s!\n", res_dir);
+		return false;
+	}
+
+	std::sort(files.begin(), files.end());
+
+	std::vector<Entry> entries(files.size());
+	std::vector<std::vector<char>> contents(files.size());
+	std::uint64_t offset = sizeof(Header) + entries.size() * sizeof(Entry);
+
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		const std::string name = files[i].lexically_relative(res_dir).generic_string();
+		Entry& entry = entries[i];
+
+		if (name.size() >= sizeof(entry.name_))
+		{
+			printf("Asset name %s is too long!\n", name.c_str());
+			return false;
+		}
+
+		std::memset(&entry, 0, sizeof(entry));
+		std::memcpy(entry.name_, name.c_str(), name.size());
+
+		if (files[i].extension() == ".png")
+		{
+			SDL_Surface* surface = DecodeImage(files[i].c_str());
+
+			if (surface == nullptr)
+			{
+				return false;
+			}
+
+			entry.type_ = EntryType::PIXELS;
+			entry.width_ = surface->w;
+			entry.height_ = surface->h;
+			entry.pitch_ = surface->w * 4;
+
+			for (int y = 0; y < surface->h; ++y)
+			{
+				const char* row = static_cast<const char*>(surface->pixels) + y * surface->pitch;
+				contents[i].insert(contents[i].end(), row, row + entry.pitch_);
+			}
+
+			SDL_FreeSurface(surface);
+		}
+		else
+		{
+			std::ifstream file(files[i], std::ios::binary);
+			contents[i].assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			entry.type_ = EntryType::FILE;
+		}
+
+		// Keep every blob 16-byte aligned so pixel rows can be read with aligned loads.
+		offset = (offset + 15) & ~static_cast<std::uint64_t>(15);
+		entry.offset_ = offset;
+		entry.size_ = contents[i].size();
+		offset += entry.size_;
+	}
+
+	const std::string tmp_path = std::string(output_path) + ".tmp";
+	std::ofstream output(tmp_path, std::ios::binary | std::ios::trunc);
+
+	Header header;
+	std::memcpy(header.magic_, magic, sizeof(magic));
+	header.n_entries_ = static_cast<std::uint32_t>(entries.size());
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		const std::vector<char> padding(entries[i].offset_ - static_cast<std::uint64_t>(output.tellp()), 0);
+		output.write(padding.data(), padding.size());
+		output.write(contents[i].data(), contents[i].size());
+	}
+
+	output.close();
+
+	if (!output || std::rename(tmp_path.c_str(), output_path) != 0)
+	{
+		printf("Failed to write asset pack %s!\n", output_path);
+		return false;
+	}
+
+	printf("Packed %zu assets into %s (%llu bytes)\n", entries.size(), output_path, static_cast<unsigned long long>(offset));
+
+	return true;
+}
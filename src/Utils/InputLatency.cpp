@@ -0,0 +1,71 @@
+#include "Utils/InputLatency.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <cstdio>
+
+InputLatency::InputLatency() : n_pending_(0), frame_(0)
+{
+}
+
+InputStamp InputLatency::Stamp() const
+{
+	return { SDL_GetPerformanceCounter(), frame_ };
+}
+
+void InputLatency::Consumed(const InputStamp& stamp)
+{
+	Consumed(stamp, SDL_GetPerformanceCounter());
+}
+
+void InputLatency::Consumed(const InputStamp& stamp, std::uint64_t consumed_counter)
+{
+	poll_to_tick_us_.Record(ElapsedMicroseconds(stamp.counter_, consumed_counter));
+
+	if (n_pending_ < max_pending)
+	{
+		pending_[n_pending_++] = stamp;
+	}
+}
+
+void InputLatency::Presented()
+{
+	const std::uint64_t now = SDL_GetPerformanceCounter();
+
+	for (std::size_t i = 0; i < n_pending_; ++i)
+	{
+		poll_to_present_us_.Record(ElapsedMicroseconds(pending_[i].counter_, now));
+		frames_to_present_.Record(frame_ - pending_[i].frame_ + 1);
+	}
+
+	n_pending_ = 0;
+	++frame_;
+}
+
+void InputLatency::Report()
+{
+	if (poll_to_present_us_.Count() == 0)
+	{
+		return;
+	}
+
+	printf("Input latency us (n=%llu) poll->tick p50: %llu p99: %llu, poll->present p50: %llu p99: %llu max: %llu, frames p50: %llu p99: %llu\n", 
+		static_cast<unsigned long long>(poll_to_present_us_.Count()), 
+		static_cast<unsigned long long>(poll_to_tick_us_.Percentile(50.0)), 
+		static_cast<unsigned long long>(poll_to_tick_us_.Percentile(99.0)), 
+		static_cast<unsigned long long>(poll_to_present_us_.Percentile(50.0)), 
+		static_cast<unsigned long long>(poll_to_present_us_.Percentile(99.0)), 
+		static_cast<unsigned long long>(poll_to_present_us_.Max()), 
+		static_cast<unsigned long long>(frames_to_present_.Percentile(50.0)), 
+		static_cast<unsigned long long>(frames_to_present_.Percentile(99.0)));
+
+	poll_to_tick_us_.Reset();
+	poll_to_present_us_.Reset();
+	frames_to_present_.Reset();
+}
+
+std::uint64_t InputLatency::ElapsedMicroseconds(std::uint64_t from, std::uint64_t to)
+{
+	return (to - from) * 1000000 / SDL_GetPerformanceFrequency();
+}
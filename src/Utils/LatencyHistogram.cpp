@@ -0,0 +1,116 @@
+#include "Utils/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram()
+{
+	Reset();
+}
+
+void LatencyHistogram::Record(std::uint64_t value)
+{
+	++counts_[BucketIndex(value)];
+	++total_count_;
+	min_ = std::min(min_, value);
+	max_ = std::max(max_, value);
+	sum_ += value;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+	for (std::size_t i = 0; i < bucket_count; ++i)
+	{
+		counts_[i] += other.counts_[i];
+	}
+
+	total_count_ += other.total_count_;
+	min_ = std::min(min_, other.min_);
+	max_ = std::max(max_, other.max_);
+	sum_ += other.sum_;
+}
+
+void LatencyHistogram::Reset()
+{
+	counts_.fill(0);
+	total_count_ = 0;
+	min_ = std::numeric_limits<std::uint64_t>::max();
+	max_ = 0;
+	sum_ = 0.0;
+}
+
+std::uint64_t LatencyHistogram::Percentile(double percentile) const
+{
+	if (total_count_ == 0)
+	{
+		return 0;
+	}
+
+	const std::uint64_t target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(total_count_ * percentile / 100.0 + 0.5));
+	std::uint64_t cumulative = 0;
+
+	for (std::size_t i = 0; i < bucket_count; ++i)
+	{
+		cumulative += counts_[i];
+
+		if (cumulative >= target)
+		{
+			return std::min(BucketUpperBound(i), max_);
+		}
+	}
+
+	return max_;
+}
+
+std::uint64_t LatencyHistogram::Count() const
+{
+	return total_count_;
+}
+
+std::uint64_t LatencyHistogram::Min() const
+{
+	return total_count_ == 0 ? 0 : min_;
+}
+
+std::uint64_t LatencyHistogram::Max() const
+{
+	return max_;
+}
+
+double LatencyHistogram::Mean() const
+{
+	return total_count_ == 0 ? 0.0 : static_cast<double>(sum_ / total_count_);
+}
+
+std::size_t LatencyHistogram::BucketIndex(std::uint64_t value)
+{
+	if (value < sub_bucket_count)
+	{
+		return static_cast<std::size_t>(value);
+	}
+
+	std::size_t exponent = 63;
+
+	while ((value >> exponent) == 0)
+	{
+		--exponent;
+	}
+
+	const std::size_t shift = exponent - sub_bucket_bits;
+
+	return (shift + 1) * sub_bucket_count + static_cast<std::size_t>((value >> shift) - sub_bucket_count);
+}
+
+std::uint64_t LatencyHistogram::BucketUpperBound(std::size_t index)
+{
+	if (index < sub_bucket_count)
+	{
+		return index;
+	}
+
+	const std::size_t shift = index / sub_bucket_count - 1;
+	const std::uint64_t sub_bucket = index % sub_bucket_count + sub_bucket_count;
+
+	return ((sub_bucket + 1) << shift) - 1;
+}
@@ -0,0 +1,230 @@
+#include "Utils/Metrics.hpp"
+#include "Utils/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace
+{
+	constexpr double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+	void AppendHeader(std::string* text, const std::string& name, const std::string& help, const char* type)
+	{
+		*text += "# HELP " + name + " " + help + "\n";
+		*text += "# TYPE " + name + " " + type + "\n";
+	}
+
+	void AppendValue(std::string* text, const char* format, ...)
+	{
+		char line[256];
+
+		va_list arguments;
+		va_start(arguments, format);
+		const int length = vsnprintf(line, sizeof(line), format, arguments);
+		va_end(arguments);
+
+		if (length > 0)
+		{
+			text->append(line, std::min<std::size_t>(static_cast<std::size_t>(length), sizeof(line) - 1));
+		}
+	}
+} // namespace
+
+MetricCounter::MetricCounter() : value_(0)
+{
+}
+
+void MetricCounter::Add(std::uint64_t n)
+{
+	value_.fetch_add(n, std::memory_order_relaxed);
+}
+
+std::uint64_t MetricCounter::Value() const
+{
+	return value_.load(std::memory_order_relaxed);
+}
+
+MetricHistogram::MetricHistogram() : count_(0), sum_(0.0)
+{
+}
+
+void MetricHistogram::Record(std::uint64_t value)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	window_.Record(value);
+	++count_;
+	sum_ += value;
+}
+
+void MetricHistogram::Collect(LatencyHistogram* window, std::uint64_t* count, long double* sum)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	*window = window_;
+	*count = count_;
+	*sum = sum_;
+	window_.Reset();
+}
+
+Metrics::Metrics()
+{
+	frame_time_us_ = &AddHistogram("tictactoe_frame_time_microseconds", "Time between the starts of consecutive frames.");
+	tick_time_us_ = &AddHistogram("tictactoe_tick_time_microseconds", "Time spent in one fixed-rate game tick.");
+	ai_move_us_ = &AddHistogram("tictactoe_ai_move_latency_microseconds", "Time from asking the AI for a move to the move being played.");
+	search_nodes_ = &AddCounter("tictactoe_search_nodes_total", "Nodes visited by the alpha-beta searches.");
+	table_probes_ = &AddCounter("tictactoe_search_table_probes_total", "Transposition table lookups.");
+	table_hits_ = &AddCounter("tictactoe_search_table_hits_total", "Transposition table lookups that found an entry.");
+	mcts_playouts_ = &AddCounter("tictactoe_mcts_playouts_total", "Playouts run by the Monte Carlo tree searches.");
+	texture_uploads_ = &AddCounter("tictactoe_texture_uploads_total", "Surfaces uploaded to the GPU as textures.");
+
+	const MetricCounter* probes = table_probes_;
+	const MetricCounter* hits = table_hits_;
+
+	AddGauge("tictactoe_search_table_hit_ratio", "Share of transposition table lookups that found an entry, over the whole run.", [probes, hits]()
+	{
+		const std::uint64_t n_probes = probes->Value();
+		return n_probes != 0 ? static_cast<double>(hits->Value()) / n_probes : 0.0;
+	});
+}
+
+Metrics& Metrics::Instance()
+{
+	static Metrics metrics;
+	return metrics;
+}
+
+MetricCounter& Metrics::AddCounter(const char* name, const char* help)
+{
+	std::lock_guard<std::mutex> lock(registry_mutex_);
+
+	families_.push_back({ name, help, Type::COUNTER, counters_.size() });
+	return counters_.emplace_back();
+}
+
+MetricHistogram& Metrics::AddHistogram(const char* name, const char* help)
+{
+	std::lock_guard<std::mutex> lock(registry_mutex_);
+
+	families_.push_back({ name, help, Type::SUMMARY, histograms_.size() });
+	return histograms_.emplace_back();
+}
+
+void Metrics::AddGauge(const char* name, const char* help, std::function<double()> value)
+{
+	std::lock_guard<std::mutex> lock(registry_mutex_);
+
+	families_.push_back({ name, help, Type::GAUGE, gauges_.size() });
+	gauges_.push_back(std::move(value));
+}
+
+std::string Metrics::Render()
+{
+	std::lock_guard<std::mutex> lock(registry_mutex_);
+
+	std::string text;
+
+	for (const Family& family : families_)
+	{
+		switch (family.type_)
+		{
+			case Type::COUNTER:
+			case Type::GAUGE:
+			{
+				const bool counter = family.type_ == Type::COUNTER;
+
+				AppendHeader(&text, family.name_, family.help_, counter ? "counter" : "gauge");
+
+				if (counter)
+				{
+					AppendValue(&text, "%s %llu\n", family.name_.c_str(), static_cast<unsigned long long>(counters_[family.index_].Value()));
+				}
+				else
+				{
+					AppendValue(&text, "%s %.9g\n", family.name_.c_str(), gauges_[family.index_]());
+				}
+
+				break;
+			}
+			case Type::SUMMARY:
+			{
+				std::uint64_t count = 0;
+				long double sum = 0.0;
+				histograms_[family.index_].Collect(&window_, &count, &sum);
+
+				// Quantiles and the max describe the last export interval; an idle interval
+				// reports NaN quantiles as Prometheus summaries do.
+				AppendHeader(&text, family.name_, family.help_ + " Quantiles cover the last export interval.", "summary");
+
+				for (const double quantile : quantiles)
+				{
+					if (window_.Count() == 0)
+					{
+						AppendValue(&text, "%s{quantile=\"%g\"} NaN\n", family.name_.c_str(), quantile);
+					}
+					else
+					{
+						AppendValue(&text, "%s{quantile=\"%g\"} %llu\n", family.name_.c_str(), quantile,
+							static_cast<unsigned long long>(window_.Percentile(quantile * 100.0)));
+					}
+				}
+
+				AppendValue(&text, "%s_sum %.0Lf\n", family.name_.c_str(), sum);
+				AppendValue(&text, "%s_count %llu\n", family.name_.c_str(), static_cast<unsigned long long>(count));
+
+				AppendHeader(&text, family.name_ + "_max", "Largest value over the last export interval.", "gauge");
+				AppendValue(&text, "%s_max %llu\n", family.name_.c_str(), static_cast<unsigned long long>(window_.Max()));
+				break;
+			}
+		}
+	}
+
+	return text;
+}
+
+MetricHistogram& Metrics::FrameTime()
+{
+	return *frame_time_us_;
+}
+
+MetricHistogram& Metrics::TickTime()
+{
+	return *tick_time_us_;
+}
+
+MetricHistogram& Metrics::AiMoveLatency()
+{
+	return *ai_move_us_;
+}
+
+MetricCounter& Metrics::SearchNodes()
+{
+	return *search_nodes_;
+}
+
+MetricCounter& Metrics::TableProbes()
+{
+	return *table_probes_;
+}
+
+MetricCounter& Metrics::TableHits()
+{
+	return *table_hits_;
+}
+
+MetricCounter& Metrics::MctsPlayouts()
+{
+	return *mcts_playouts_;
+}
+
+MetricCounter& Metrics::TextureUploads()
+{
+	return *texture_uploads_;
+}
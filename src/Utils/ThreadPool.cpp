@@ -0,0 +1,75 @@
+#include "Utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+ThreadPool::ThreadPool(std::size_t n_workers) : stopping_(false)
+{
+	if (n_workers == 0)
+	{
+		n_workers = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	workers_.reserve(n_workers);
+
+	for (std::size_t i = 0; i < n_workers; ++i)
+	{
+		workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+
+	condition_.notify_all();
+
+	for (std::thread& worker : workers_)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Submit(std::function<void(std::size_t)> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back(std::move(job));
+	}
+
+	condition_.notify_one();
+}
+
+std::size_t ThreadPool::Workers() const
+{
+	return workers_.size();
+}
+
+void ThreadPool::WorkerLoop(std::size_t worker_index)
+{
+	while (true)
+	{
+		std::function<void(std::size_t)> job;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+
+			if (jobs_.empty())
+			{
+				return;
+			}
+
+			job = std::move(jobs_.front());
+			jobs_.pop_front();
+		}
+
+		job(worker_index);
+	}
+}
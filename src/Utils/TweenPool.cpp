@@ -0,0 +1,147 @@
+#include "Utils/TweenPool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	constexpr std::uint16_t inactive = 0xFFFF;
+} // namespace
+
+TweenPool::TweenPool()
+{
+	generation_.fill(0);
+	Clear();
+}
+
+TweenHandle TweenPool::Start(float from, float to, int duration_ticks, Easing easing, int delay_ticks)
+{
+	if (n_free_ == 0)
+	{
+		return invalid_tween;
+	}
+
+	const std::uint16_t index = free_[--n_free_];
+
+	from_[index] = from;
+	to_[index] = to;
+	elapsed_ticks_[index] = -std::max(0, delay_ticks);
+	duration_ticks_[index] = std::max(1, duration_ticks);
+	easing_[index] = easing;
+
+	active_position_[index] = static_cast<std::uint16_t>(n_active_);
+	active_[n_active_++] = index;
+
+	return (static_cast<TweenHandle>(generation_[index]) << 16) | index;
+}
+
+void TweenPool::Update()
+{
+	std::size_t i = 0;
+
+	while (i < n_active_)
+	{
+		const std::uint16_t index = active_[i];
+
+		if (++elapsed_ticks_[index] >= duration_ticks_[index])
+		{
+			Deactivate(index);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+float TweenPool::Value(TweenHandle handle, float alpha) const
+{
+	if (!Valid(handle))
+	{
+		return 1.0f;
+	}
+
+	const std::uint16_t index = handle & 0xFFFF;
+	const float elapsed = active_position_[index] == inactive ? static_cast<float>(duration_ticks_[index]) : elapsed_ticks_[index] + alpha;
+	const float t = std::clamp(elapsed / duration_ticks_[index], 0.0f, 1.0f);
+
+	return from_[index] + (to_[index] - from_[index]) * Ease(easing_[index], t);
+}
+
+bool TweenPool::Finished(TweenHandle handle) const
+{
+	return !Valid(handle) || active_position_[handle & 0xFFFF] == inactive;
+}
+
+void TweenPool::Release(TweenHandle* handle)
+{
+	if (Valid(*handle))
+	{
+		const std::uint16_t index = *handle & 0xFFFF;
+
+		if (active_position_[index] != inactive)
+		{
+			Deactivate(index);
+		}
+
+		++generation_[index];
+		free_[n_free_++] = index;
+	}
+
+	*handle = invalid_tween;
+}
+
+void TweenPool::Clear()
+{
+	for (std::size_t i = 0; i < capacity; ++i)
+	{
+		++generation_[i];
+		active_position_[i] = inactive;
+		free_[i] = static_cast<std::uint16_t>(capacity - 1 - i);
+	}
+
+	n_free_ = capacity;
+	n_active_ = 0;
+}
+
+std::size_t TweenPool::Active() const
+{
+	return n_active_;
+}
+
+bool TweenPool::Valid(TweenHandle handle) const
+{
+	const std::uint32_t index = handle & 0xFFFF;
+
+	return handle != invalid_tween && index < capacity && generation_[index] == (handle >> 16);
+}
+
+void TweenPool::Deactivate(std::uint16_t index)
+{
+	const std::uint16_t position = active_position_[index];
+	const std::uint16_t last = active_[--n_active_];
+
+	active_[position] = last;
+	active_position_[last] = position;
+	active_position_[index] = inactive;
+}
+
+float TweenPool::Ease(Easing easing, float t)
+{
+	switch (easing)
+	{
+		case Easing::EASE_OUT_CUBIC:
+		{
+			const float u = 1.0f - t;
+			return 1.0f - u * u * u;
+		}
+
+		case Easing::EASE_IN_OUT:
+			return t * t * (3.0f - 2.0f * t);
+
+		case Easing::LINEAR:
+			break;
+	}
+
+	return t;
+}
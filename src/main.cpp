@@ -1,14 +1,158 @@
+#include "AI/Evaluator.hpp"
+#include "AI/Network.hpp"
+#include "Modes/EngineMode.hpp"
+#include "Modes/RenderMode.hpp"
+#include "Modes/ServerMode.hpp"
+#include "Modes/SolverMode.hpp"
+#include "Modes/TrainingMode.hpp"
+#include "Modes/TuneMode.hpp"
+#include "Server/MetricsExporter.hpp"
+#include "States/ExhibitionState.hpp"
+#include "Utils/AllocationTracker.hpp"
+#include "Utils/AssetPack.hpp"
+#include "Utils/Constants.hpp"
 #include "Game.hpp"
 
+#include <SDL2/SDL.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <string>
+
+namespace
+{
+	// Tuned evaluation weights (./output --tune) and an optional network for large boards are
+	// picked up from next to the executable.
+	void LoadEvaluatorWeights()
+	{
+		char* base_path = SDL_GetBasePath();
+		const std::string directory = base_path != nullptr ? base_path : "";
+		SDL_free(base_path);
+
+		const std::string weights_path = directory + "weights.bin";
+		const std::string network_path = directory + "network.nnue";
+
+		if (Evaluator::Default().LoadFromFile(weights_path.c_str()))
+		{
+			fprintf(stderr, "Loaded evaluation weights from %s\n", weights_path.c_str());
+		}
+
+		if (Network::Default().LoadFromFile(network_path.c_str()))
+		{
+			fprintf(stderr, "Loaded evaluation network from %s\n", network_path.c_str());
+		}
+	}
+} // namespace
 
 int main(int argc, char* argv[])
 {
-	(void)argc;
-	(void)argv;
+	LoadEvaluatorWeights();
+
+	// Flags may sit anywhere after the mode, so a game, a kiosk exhibition or a server can all be
+	// scraped. They are taken out of argv before dispatch, so the modes' own parsers (positional
+	// or strict) never see them. The exporter lives until main returns.
+	std::string metrics_path;
+	std::uint16_t metrics_port = 0;
+	int n_arguments = 1;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (i + 1 < argc && std::strcmp(argv[i], "--metrics-file") == 0)
+		{
+			metrics_path = argv[++i];
+		}
+		else if (i + 1 < argc && std::strcmp(argv[i], "--metrics-port") == 0)
+		{
+			metrics_port = static_cast<std::uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			argv[n_arguments++] = argv[i];
+		}
+	}
+
+	argc = n_arguments;
+	argv[argc] = nullptr;
+
+	MetricsExporter metrics_exporter;
+
+	if ((!metrics_path.empty() || metrics_port != 0) && 
+		!metrics_exporter.Start(metrics_path, metrics_port, std::chrono::milliseconds(constants::metrics_export_milliseconds)))
+	{
+		return 1;
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--solve") == 0)
+	{
+		return RunSolverMode(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--engine") == 0)
+	{
+		return RunEngineMode();
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--server") == 0)
+	{
+		return RunServerMode(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--server-load") == 0)
+	{
+		return RunLoadClientMode(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--render") == 0)
+	{
+		return RunRenderMode(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--tune") == 0)
+	{
+		return RunTuneMode(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--train") == 0)
+	{
+		return RunTrainingMode(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--pack-assets") == 0)
+	{
+		return AssetPack::Build(argc > 2 ? argv[2] : "res", argc > 3 ? argv[3] : "assets.pak") ? 0 : 1;
+	}
 
 	std::unique_ptr<Game> game = std::make_unique<Game>();
+
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--tick-rate") == 0)
+		{
+			game->SetTickRate(std::strtod(argv[i + 1], nullptr));
+		}
+		else if (std::strcmp(argv[i], "--max-catch-up") == 0)
+		{
+			game->SetMaxCatchUpTicks(std::atoi(argv[i + 1]));
+		}
+		else if (std::strcmp(argv[i], "--boards") == 0)
+		{
+			ExhibitionState::Instance()->SetBoards(std::strtoul(argv[i + 1], nullptr, 10));
+		}
+	}
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--zero-alloc") == 0)
+		{
+			AllocationTracker::SetStrict(true);
+		}
+	}
+
 	game->Run();
 
 	return 0;
-}
\ No newline at end of file
+}